@@ -5,610 +5,7669 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <bitset>
 #include <cctype>
+#include <cfloat>
+#include <charconv>
+#include <clocale>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <regex>
 #include <set>
+#include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #ifdef STRUTIL_ENABLE_PARALLEL
-#  include <execution>
+#  include <atomic>
+#  include <condition_variable>
+#  include <deque>
+#  include <exception>
+#  include <thread>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#endif
+
+// Explicit SIMD kernels (SSE2 baseline, AVX2/AVX-512 picked at runtime) are
+// used on x86 when SSE2 is available. Define STRUTIL_DISABLE_SIMD before
+// including the header to force the portable scalar code paths.
+#if !defined(STRUTIL_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#  define STRUTIL_X86_SIMD 1
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define STRUTIL_TARGET(features) __attribute__((target(features)))
+#  else
+#    define STRUTIL_TARGET(features)
+#  endif
 #endif
 
 //! The strutil namespace
 namespace strutil
 {
-    /**
-     * @brief Converts any datatype into std::string.
-     *        Datatype must support << operator.
-     * @tparam T
-     * @param value - will be converted into std::string.
-     * @return Converted value as std::string.
-     */
-    template<typename T>
-    inline std::string to_string(T value)
+    namespace detail
     {
-        std::stringstream ss;
-        ss << value;
+        // Index of the lowest set bit; mask must be non-zero.
+        inline unsigned count_trailing_zeros(uint64_t mask)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index = 0;
+#  if defined(_M_X64)
+            _BitScanForward64(&index, mask);
+#  else
+            if (!_BitScanForward(&index, static_cast<unsigned long>(mask)))
+            {
+                _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+                index += 32;
+            }
+#  endif
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+        }
 
-        return ss.str();
-    }
+        inline unsigned popcount(uint64_t mask)
+        {
+            mask = mask - ((mask >> 1) & 0x5555555555555555ULL);
+            mask = (mask & 0x3333333333333333ULL) + ((mask >> 2) & 0x3333333333333333ULL);
+            mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<unsigned>((mask * 0x0101010101010101ULL) >> 56);
+        }
 
-    /**
-     * @brief Converts std::string into any datatype.
-     *        Datatype must support >> operator.
-     *        On parse failure the result is value-initialized (e.g. 0 for
-     *        arithmetic types, false for bool). Use try_parse_string if you
-     *        need to distinguish failure from a legitimate zero/default value.
-     *        For floating-point types, parsing uses std::strtof/strtod/strtold
-     *        rather than stream extraction, so trailing non-numeric characters
-     *        (e.g. "5.245f") are consistently ignored across libstdc++/libc++.
-     * @tparam T
-     * @param str - std::string that will be converted into datatype T.
-     * @return Variable of datatype T, or T{} on parse failure.
-     */
-    template<typename T>
-    inline T parse_string(const std::string & str)
-    {
-        T result{};
-        std::istringstream(str) >> result;
+        // Instruction set extensions beyond the SSE2 baseline, detected once
+        // per process. All flags stay false when STRUTIL_X86_SIMD is off.
+        struct cpu_features
+        {
+            bool ssse3    = false;
+            bool avx2     = false;
+            bool avx512bw = false;
+        };
 
-        return result;
+        inline cpu_features detect_cpu_features()
+        {
+            cpu_features features;
+#if defined(STRUTIL_X86_SIMD)
+#  if defined(_MSC_VER) && !defined(__clang__)
+            int info[4] = {};
+            __cpuid(info, 0);
+            const int max_leaf = info[0];
+
+            __cpuid(info, 1);
+            features.ssse3 = (info[2] & (1 << 9)) != 0;
+            const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x06) == 0x06;
+            const bool os_saves_zmm = os_saves_ymm && (_xgetbv(0) & 0xE0) == 0xE0;
+
+            if (max_leaf >= 7)
+            {
+                __cpuidex(info, 7, 0);
+                features.avx2     = os_saves_ymm && (info[1] & (1 << 5)) != 0;
+                features.avx512bw = os_saves_zmm && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+            }
+#  else
+            __builtin_cpu_init();
+            features.ssse3    = __builtin_cpu_supports("ssse3");
+            features.avx2     = __builtin_cpu_supports("avx2");
+            features.avx512bw = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#  endif
+#endif
+            return features;
+        }
+
+        inline const cpu_features & cpu()
+        {
+            static const cpu_features features = detect_cpu_features();
+            return features;
+        }
     }
 
+#ifdef STRUTIL_ENABLE_PARALLEL
     /**
-     * @brief Like parse_string, but reports failure explicitly via std::optional.
-     *        Returns std::nullopt if the input could not be parsed as T.
-     *        Note: trailing junk after a valid prefix is ignored (this matches
-     *        std::istringstream semantics), e.g. try_parse_string<int>("42abc")
-     *        returns 42, not nullopt.
-     * @tparam T
-     * @param str - std::string that will be converted into datatype T.
-     * @return std::optional<T> containing the parsed value, or std::nullopt on failure.
+     * @brief Dependency-free work-stealing thread pool behind the *_par
+     *        functions. Every thread owns a task deque: it works on its newest
+     *        task and, when out of work, steals the oldest task of another.
+     *        parallel_for splits ranges in halves on demand, so thieves take
+     *        the biggest pieces first. The calling thread helps only while
+     *        tasks are queued; once every queue is empty it sleeps until its
+     *        call's tasks finish. Nested calls still finish: a thread sleeps
+     *        only after it finds every queue empty, and each pusher drains
+     *        its own queue.
+     *        The *_par functions share one pool, sized by
+     *        set_parallel_threads; threads are reused across calls.
      */
-    template<typename T>
-    inline std::optional<T> try_parse_string(const std::string & str)
+    class thread_pool
     {
-        T result{};
-        std::istringstream iss(str);
-        iss >> result;
-        if (iss.fail())
+    public:
+        /**
+         * @param threads - number of threads working on a call, the calling
+         *                  thread included; 0 (default) uses
+         *                  std::thread::hardware_concurrency().
+         */
+        explicit thread_pool(size_t threads = 0)
         {
-            return std::nullopt;
+            if (threads == 0)
+            {
+                threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+            }
+            queue_count_ = threads;
+            queues_.reset(new task_queue[threads]);
+            try
+            {
+                workers_.reserve(threads - 1);
+                for (size_t i = 1; i < threads; ++i)
+                {
+                    workers_.emplace_back([this, i]() { work(i); });
+                }
+            }
+            catch (...)
+            {
+                stop();
+                throw;
+            }
         }
-        return result;
-    }
 
-    // Floating-point specializations.
-    //
-    // Stream extraction of floats with trailing non-numeric characters
-    // (e.g. "5.245f") is implementation-defined — libstdc++ accepts the
-    // numeric prefix while libc++ rejects the whole input. We delegate to
-    // std::strtof/strtod/strtold instead, which always parse the longest
-    // valid prefix and behave identically across standard library
-    // implementations.
+        ~thread_pool()
+        {
+            stop();
+        }
 
-    template<>
-    inline float parse_string<float>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const float result = std::strtof(begin, &end);
-        return (end == begin) ? 0.0f : result;
-    }
+        thread_pool(const thread_pool &) = delete;
+        thread_pool & operator=(const thread_pool &) = delete;
 
-    template<>
-    inline double parse_string<double>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const double result = std::strtod(begin, &end);
-        return (end == begin) ? 0.0 : result;
-    }
+        //! Number of threads working on a call, the calling thread included.
+        size_t concurrency() const
+        {
+            return workers_.size() + 1;
+        }
 
-    template<>
-    inline long double parse_string<long double>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const long double result = std::strtold(begin, &end);
-        return (end == begin) ? 0.0L : result;
-    }
+        /**
+         * @brief Calls task(first, last) on consecutive ranges covering
+         *        [0, count), none longer than grain, and returns when all of
+         *        them are done. At most grain elements, or a pool of one
+         *        thread, run serially on the calling thread. task may be
+         *        called concurrently and may itself call parallel_for. The
+         *        first exception thrown by task is rethrown.
+         * @param count - number of elements.
+         * @param grain - the longest range passed to task (at least 1).
+         * @param task - callable taking the bounds of a range of elements.
+         */
+        template<typename Task>
+        void parallel_for(size_t count, size_t grain, const Task & task)
+        {
+            grain = std::max<size_t>(grain, 1);
+            if (count <= grain || workers_.empty())
+            {
+                if (count != 0)
+                {
+                    task(size_t(0), count);
+                }
+                return;
+            }
 
-    template<>
-    inline std::optional<float> try_parse_string<float>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const float result = std::strtof(begin, &end);
-        if (end == begin) return std::nullopt;
-        return result;
-    }
+            task_group group;
+            split_range(group, 0, count, grain, task);
 
-    template<>
-    inline std::optional<double> try_parse_string<double>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const double result = std::strtod(begin, &end);
-        if (end == begin) return std::nullopt;
-        return result;
-    }
+            // Help with queued tasks; when there are none for a while, sleep
+            // until the last task of the group is done rather than spin.
+            const size_t self = own_queue();
+            std::function<void()> job;
+            for (unsigned idle = 0; group.pending.load() != 0;)
+            {
+                if (take(self, job))
+                {
+                    job();
+                    job  = nullptr;
+                    idle = 0;
+                }
+                else if (++idle < spin_limit)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::unique_lock<std::mutex> lock(group.mutex);
+                    group.done.wait(lock, [&group]() { return group.pending.load() == 0; });
+                }
+            }
+            {
+                // The last task may still be notifying under the lock.
+                std::lock_guard<std::mutex> lock(group.mutex);
+            }
+            if (group.error)
+            {
+                std::rethrow_exception(group.error);
+            }
+        }
 
-    template<>
-    inline std::optional<long double> try_parse_string<long double>(const std::string & str)
-    {
-        const char * begin = str.c_str();
-        char * end = nullptr;
-        const long double result = std::strtold(begin, &end);
-        if (end == begin) return std::nullopt;
-        return result;
-    }
+    private:
+        static constexpr unsigned spin_limit = 64;
 
-    /**
-     * @brief Converts std::string to lower case.
-     * @param str - std::string that needs to be converted.
-     * @return Lower case input std::string.
-     */
-    inline std::string to_lower(const std::string & str)
-    {
-        auto result = str;
-        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) -> unsigned char
+        struct task_queue
         {
-            return static_cast<unsigned char>(std::tolower(c));
-        });
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks;
+        };
 
-        return result;
-    }
+        struct task_group
+        {
+            std::atomic<size_t>     pending { 0 };
+            std::mutex              mutex;
+            std::condition_variable done;
+            std::mutex              error_mutex;
+            std::exception_ptr      error;
+        };
 
-    /**
-     * @brief Converts std::string to upper case.
-     * @param str - std::string that needs to be converted.
-     * @return Upper case input std::string.
-     */
-    inline std::string to_upper(const std::string & str)
-    {
-        auto result = str;
-        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) -> unsigned char
+        // Counts a task of group as done. The last one decrements under the
+        // lock, so the waiting caller cannot miss the notification or return
+        // and destroy group before it is sent.
+        static void finish(task_group & group)
         {
-            return static_cast<unsigned char>(std::toupper(c));
-        });
+            size_t pending = group.pending.load();
+            while (pending > 1)
+            {
+                if (group.pending.compare_exchange_weak(pending, pending - 1))
+                {
+                    return;
+                }
+            }
+            std::lock_guard<std::mutex> lock(group.mutex);
+            group.pending.fetch_sub(1);
+            group.done.notify_one();
+        }
 
-        return result;
-    }
+        // The pool and queue of the calling thread; threads outside the
+        // pool share queue 0.
+        static std::pair<const thread_pool *, size_t> & current()
+        {
+            static thread_local std::pair<const thread_pool *, size_t> current { nullptr, 0 };
+            return current;
+        }
 
-    /**
-     * @brief Converts the first character of a string to uppercase letter and lowercases all other characters, if any.
-     * @param str - input string to be capitalized.
-     * @return A string with the first letter capitalized and all other characters lowercased. It doesn't modify the input string.
-     */
-    inline std::string capitalize(const std::string & str)
-    {
-        auto result = str;
-        if (!result.empty())
+        size_t own_queue() const
         {
-            result.front() = static_cast<char>(std::toupper(result.front()));
+            return current().first == this ? current().second : 0;
         }
 
-        return result;
-    }
+        // Runs [begin, end), first pushing its upper halves as tasks until
+        // the rest fits in grain.
+        template<typename Task>
+        void split_range(task_group & group, size_t begin, size_t end, size_t grain, const Task & task)
+        {
+            try
+            {
+                while (end - begin > grain)
+                {
+                    const size_t middle = begin + (end - begin) / 2;
+                    group.pending.fetch_add(1);
+                    try
+                    {
+                        push([this, &group, middle, end, grain, &task]()
+                        {
+                            split_range(group, middle, end, grain, task);
+                            finish(group);
+                        });
+                    }
+                    catch (...)
+                    {
+                        group.pending.fetch_sub(1);
+                        throw;
+                    }
+                    end = middle;
+                }
+                task(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(group.error_mutex);
+                if (!group.error)
+                {
+                    group.error = std::current_exception();
+                }
+            }
+        }
 
-    /**
-     * @brief Converts only the first character of a string to uppercase letter, all other characters stay unchanged.
-     * @param str - input string to be modified.
-     * @return A string with the first letter capitalized. All other characters stay unchanged. It doesn't modify the input string.
-     */
-    inline std::string capitalize_first_char(const std::string & str)
-    {
-        auto result = to_lower(str);
-        if (!result.empty())
+        void push(std::function<void()> job)
         {
-            result.front() = static_cast<char>(std::toupper(result.front()));
+            task_queue & queue = queues_[own_queue()];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(job));
+                ++queued_;
+            }
+            {
+                // Taken so a worker cannot miss the notification between
+                // checking queued_ and going to sleep.
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+            }
+            wake_.notify_one();
         }
 
-        return result;
-    }
+        // Pops the newest task of queue self, or steals the oldest of another.
+        bool take(size_t self, std::function<void()> & job)
+        {
+            for (size_t k = 0; k < queue_count_; ++k)
+            {
+                task_queue & queue = queues_[(self + k) % queue_count_];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty())
+                {
+                    if (k == 0)
+                    {
+                        job = std::move(queue.tasks.back());
+                        queue.tasks.pop_back();
+                    }
+                    else
+                    {
+                        job = std::move(queue.tasks.front());
+                        queue.tasks.pop_front();
+                    }
+                    --queued_;
+                    return true;
+                }
+            }
+            return false;
+        }
 
-    /**
-     * @brief Checks if input std::string str contains specified substring.
-     * @param str - std::string to be checked.
-     * @param substring - searched substring.
-     * @return True if substring was found in str, false otherwise.
-     */
-    inline bool contains(const std::string & str, const std::string & substring)
-    {
-        return str.find(substring) != std::string::npos;
-    }
+        void work(size_t self)
+        {
+            current() = { this, self };
+            std::function<void()> job;
+            for (;;)
+            {
+                if (take(self, job))
+                {
+                    job();
+                    job = nullptr;
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleep_mutex_);
+                wake_.wait(lock, [this]() { return stopping_ || queued_.load() != 0; });
+                if (stopping_)
+                {
+                    return;
+                }
+            }
+        }
 
-    /**
-     * @brief Checks if input std::string str contains specified character.
-     * @param str - std::string to be checked.
-     * @param character - searched character.
-     * @return True if character was found in str, false otherwise.
-     */
-    inline bool contains(const std::string & str, const char character)
+        void stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (std::thread & worker : workers_)
+            {
+                worker.join();
+            }
+        }
+
+        size_t                        queue_count_ = 0;
+        std::unique_ptr<task_queue[]> queues_;
+        std::vector<std::thread>      workers_;
+        std::atomic<size_t>           queued_ { 0 };
+        std::mutex                    sleep_mutex_;
+        std::condition_variable       wake_;
+        bool                          stopping_ = false;
+    };
+
+    namespace detail
     {
-        return str.find(character) != std::string::npos;
+        struct parallel_settings
+        {
+            std::mutex                   mutex;
+            std::shared_ptr<thread_pool> pool;
+            size_t                       threads = 0;
+            std::atomic<size_t>          grain { 2048 };
+        };
+
+        inline parallel_settings & parallel_config()
+        {
+            static parallel_settings settings;
+            return settings;
+        }
+
+        // The shared pool, created on first use. Callers hold the pointer
+        // for the whole call, so resizing never pulls it from under them.
+        inline std::shared_ptr<thread_pool> parallel_pool()
+        {
+            parallel_settings & settings = parallel_config();
+            std::lock_guard<std::mutex> lock(settings.mutex);
+            if (!settings.pool)
+            {
+                settings.pool = std::make_shared<thread_pool>(settings.threads);
+            }
+            return settings.pool;
+        }
     }
 
     /**
-     * @brief Compares two std::strings ignoring their case (lower/upper).
-     * @param str1 - std::string to compare
-     * @param str2 - std::string to compare
-     * @return True if str1 and str2 are equal, false otherwise.
+     * @brief Sets the number of threads the *_par functions use, the calling
+     *        thread included; 0 (the default) uses
+     *        std::thread::hardware_concurrency(). The shared pool is rebuilt
+     *        on next use; calls already running finish on the old one.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param threads - number of threads.
      */
-    inline bool compare_ignore_case(const std::string & str1, const std::string & str2)
+    inline void set_parallel_threads(size_t threads)
     {
-        return to_lower(str1) == to_lower(str2);
+        detail::parallel_settings & settings = detail::parallel_config();
+        std::lock_guard<std::mutex> lock(settings.mutex);
+        settings.threads = threads;
+        settings.pool.reset();
     }
 
     /**
-     * @brief Trims (in-place) white spaces from the left side of std::string.
-     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
-     * @param str - input std::string to remove white spaces from.
+     * @brief Number of threads the *_par functions use, the calling thread included.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
      */
-    inline void trim_left(std::string & str)
+    inline size_t parallel_threads()
     {
-        str.erase(str.begin(), std::find_if(str.begin(), str.end(), [](unsigned char ch) { return !std::isspace(ch); }));
+        return detail::parallel_pool()->concurrency();
     }
 
     /**
-     * @brief Trims (in-place) white spaces from the right side of std::string.
-     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
-     * @param str - input std::string to remove white spaces from.
+     * @brief Sets the grain of the element-wise *_par functions (sorting,
+     *        drop_duplicate, the batch transforms): work is handed out in
+     *        tasks of at most grain elements, and containers of at most
+     *        grain elements stay serial on the calling thread. Default 2048.
+     *        split_par chunks by bytes and is not affected.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param grain - number of elements (at least 1).
      */
-    inline void trim_right(std::string & str)
+    inline void set_parallel_grain(size_t grain)
     {
-        str.erase(std::find_if(str.rbegin(), str.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), str.end());
+        detail::parallel_config().grain = std::max<size_t>(grain, 1);
     }
 
     /**
-     * @brief Trims (in-place) white spaces from the both sides of std::string.
-     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
-     * @param str - input std::string to remove white spaces from.
+     * @brief Grain of the element-wise *_par functions; see set_parallel_grain.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
      */
-    inline void trim(std::string & str)
+    inline size_t parallel_grain()
     {
-        trim_left(str);
-        trim_right(str);
+        return detail::parallel_config().grain;
     }
+#endif // STRUTIL_ENABLE_PARALLEL
 
-     /**
-      * @brief Trims white spaces from the left side of std::string.
-      *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
-      * @param str - input std::string to remove white spaces from.
-      * @return Copy of input str with trimmed white spaces.
-      */
-    inline std::string trim_left_copy(std::string str)
+    namespace detail
     {
-        trim_left(str);
-        return str;
-    }
+        template<typename T> struct is_character : std::false_type {};
+        template<> struct is_character<char>          : std::true_type {};
+        template<> struct is_character<signed char>   : std::true_type {};
+        template<> struct is_character<unsigned char> : std::true_type {};
+        template<> struct is_character<wchar_t>       : std::true_type {};
+        template<> struct is_character<char16_t>      : std::true_type {};
+        template<> struct is_character<char32_t>      : std::true_type {};
 
-    /**
-      * @brief Trims white spaces from the right side of std::string.
+        // Types parse_string/try_parse_string hand over to parse_number and
+        // to_string formats with std::to_chars. Character types keep their
+        // stream semantics ("d" parses as 'd', 'd' formats as "d").
+        template<typename T>
+        constexpr bool is_parsable_number_v = std::is_arithmetic_v<T> && !is_character<std::remove_cv_t<T>>::value;
+
+        // Enough room for any value format_number produces for T.
+        template<typename T>
+        constexpr size_t max_number_chars = std::is_floating_point_v<T> ? 64 : std::numeric_limits<T>::digits10 + 3;
+
+        template<typename T>
+        inline std::to_chars_result format_number(char * first, char * last, T value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                if (first == last)
+                {
+                    return { last, std::errc::value_too_large };
+                }
+                *first = value ? '1' : '0';
+                return { first + 1, std::errc{} };
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                return std::to_chars(first, last, value);
+            }
+            else
+            {
+#if defined(__cpp_lib_to_chars)
+                if constexpr (std::is_same_v<T, long double>)
+                {
+                    // Same digits as the stream default (%g, 6 significant digits).
+                    return std::to_chars(first, last, value, std::chars_format::general, 6);
+                }
+                else
+                {
+                    // Shortest representation that parses back to the same value.
+                    return std::to_chars(first, last, value);
+                }
+#else
+                // No floating-point to_chars: round-trip precision through
+                // snprintf, with the locale's decimal point put back to '.'.
+                char buffer[max_number_chars<T>];
+                const int precision = std::is_same_v<T, long double> ? 6 : std::numeric_limits<T>::max_digits10;
+                const int length = std::is_same_v<T, long double>
+                    ? std::snprintf(buffer, sizeof(buffer), "%.*Lg", precision, static_cast<long double>(value))
+                    : std::snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+                if (length < 0 || length > last - first)
+                {
+                    return { last, std::errc::value_too_large };
+                }
+
+                const char point = *std::localeconv()->decimal_point;
+                for (int i = 0; i < length; ++i)
+                {
+                    first[i] = buffer[i] == point ? '.' : buffer[i];
+                }
+                return { first + length, std::errc{} };
+#endif
+            }
+        }
+    }
+
+    /**
+     * @brief Converts any datatype into std::string.
+     *        Datatype must support << operator.
+     *        Arithmetic types (except character types) are formatted with
+     *        std::to_chars instead of a stream: integers in base 10, bool as
+     *        "1"/"0", float and double in the shortest form that parses back
+     *        to the same value, and long double with 6 significant digits.
+     * @tparam T
+     * @param value - will be converted into std::string.
+     * @return Converted value as std::string.
+     */
+    template<typename T>
+    inline std::string to_string(T value)
+    {
+        if constexpr (detail::is_parsable_number_v<T>)
+        {
+            char buffer[detail::max_number_chars<T>];
+            const auto result = detail::format_number(buffer, buffer + sizeof(buffer), value);
+            return std::string(buffer, result.ptr);
+        }
+        else
+        {
+            std::stringstream ss;
+            ss << value;
+
+            return ss.str();
+        }
+    }
+
+    /**
+     * @brief Formats an arithmetic value into the caller-supplied buffer
+     *        [first, last) without allocating, in the same format as
+     *        to_string(T). No terminating NUL is written.
+     * @tparam T - arithmetic, non-character type.
+     * @param value - will be formatted.
+     * @param first - beginning of the output buffer.
+     * @param last - end of the output buffer.
+     * @return std::to_chars_result with ptr one past the last written
+     *         character, or ptr == last and std::errc::value_too_large if
+     *         the buffer is too small.
+     */
+    template<typename T>
+    inline std::to_chars_result to_string(T value, char * first, char * last)
+    {
+        static_assert(detail::is_parsable_number_v<T>, "to_string into a buffer requires an arithmetic, non-character type");
+        return detail::format_number(first, last, value);
+    }
+
+    /**
+     * @brief Appends an arithmetic value to output, in the same format as
+     *        to_string(T). Allocates only if output has to grow.
+     * @tparam T - arithmetic, non-character type.
+     * @param output - std::string the formatted value is appended to.
+     * @param value - will be formatted.
+     */
+    template<typename T>
+    inline void append_to_string(std::string & output, T value)
+    {
+        static_assert(detail::is_parsable_number_v<T>, "append_to_string requires an arithmetic, non-character type");
+
+        char buffer[detail::max_number_chars<T>];
+        const auto result = detail::format_number(buffer, buffer + sizeof(buffer), value);
+        output.append(buffer, result.ptr);
+    }
+
+    /**
+     * @brief Outcome of parse_number: the parsed value together with the
+     *        position where parsing stopped and the reason it stopped.
+     * @tparam T - parsed arithmetic type.
+     */
+    template<typename T>
+    struct parse_result
+    {
+        //! Parsed value, or T{} on failure.
+        T value{};
+        //! On success, offset one past the last consumed character; on failure,
+        //! offset of the character where parsing stopped.
+        size_t pos = 0;
+        //! std::errc{} on success, std::errc::invalid_argument if no number could
+        //! be parsed (or strict mode found trailing characters), and
+        //! std::errc::result_out_of_range if the number does not fit into T.
+        std::errc ec{};
+
+        explicit operator bool() const noexcept { return ec == std::errc{}; }
+    };
+
+    namespace detail
+    {
+        // Same set as std::isspace in the "C" locale.
+        inline bool is_space(char c)
+        {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+    }
+
+    namespace detail
+    {
+        // Locale-independent floating-point parsing engine behind parse_number.
+        //
+        // Decimal input is converted with the Clinger fast path when the
+        // mantissa and the power of ten are both exactly representable, with
+        // the Eisel-Lemire algorithm (as popularized by fast_float) otherwise,
+        // and with an exact big-decimal conversion in the rare cases where
+        // more than 19 significant digits leave Eisel-Lemire undecided. All
+        // paths round to nearest, ties to even, like strtod in the "C" locale.
+        // Hexadecimal floats, inf/infinity and nan/nan(chars) follow the
+        // strtod grammar.
+
+        inline unsigned count_leading_zeros(uint64_t value)
+        {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return 63u - static_cast<unsigned>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_clzll(value));
+#else
+            unsigned count = 0;
+            for (uint64_t bit = uint64_t(1) << 63; (value & bit) == 0; bit >>= 1)
+            {
+                ++count;
+            }
+            return count;
+#endif
+        }
+
+        // Full 64x64 -> 128 bit product; returns the low half.
+        inline uint64_t multiply_64x64(uint64_t a, uint64_t b, uint64_t & high)
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ using uint128 = unsigned __int128;
+            const uint128 product = static_cast<uint128>(a) * b;
+            high = static_cast<uint64_t>(product >> 64);
+            return static_cast<uint64_t>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return _umul128(a, b, &high);
+#else
+            const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+            const uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+            const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+            const uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+            return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+        }
+
+        template<typename T> struct binary_format;
+
+        template<> struct binary_format<double>
+        {
+            using bits_type = uint64_t;
+            static constexpr int      mantissa_bits              = 52;
+            static constexpr int      exponent_bits              = 11;
+            static constexpr int      minimum_exponent           = -1023;
+            static constexpr int      infinite_power             = 0x7FF;
+            static constexpr int      smallest_power_of_ten      = -342;
+            static constexpr int      largest_power_of_ten       = 308;
+            static constexpr int      min_exponent_round_to_even = -4;
+            static constexpr int      max_exponent_round_to_even = 23;
+            static constexpr int      max_exponent_fast_path     = 22;
+            static constexpr uint64_t max_mantissa_fast_path     = uint64_t(2) << 52;
+
+            static double exact_power_of_ten(int exponent)
+            {
+                static constexpr double powers[] = { 1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+                return powers[exponent];
+            }
+        };
+
+        template<> struct binary_format<float>
+        {
+            using bits_type = uint32_t;
+            static constexpr int      mantissa_bits              = 23;
+            static constexpr int      exponent_bits              = 8;
+            static constexpr int      minimum_exponent           = -127;
+            static constexpr int      infinite_power             = 0xFF;
+            static constexpr int      smallest_power_of_ten      = -65;
+            static constexpr int      largest_power_of_ten       = 38;
+            static constexpr int      min_exponent_round_to_even = -17;
+            static constexpr int      max_exponent_round_to_even = 10;
+            static constexpr int      max_exponent_fast_path     = 10;
+            static constexpr uint64_t max_mantissa_fast_path     = uint64_t(2) << 23;
+
+            static float exact_power_of_ten(int exponent)
+            {
+                static constexpr float powers[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+                return powers[exponent];
+            }
+        };
+
+        // Binary significand (without the implicit bit) and biased exponent.
+        struct adjusted_mantissa
+        {
+            uint64_t mantissa = 0;
+            int      power2   = 0;
+
+            bool operator==(const adjusted_mantissa & other) const
+            {
+                return mantissa == other.mantissa && power2 == other.power2;
+            }
+
+            bool operator!=(const adjusted_mantissa & other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+        template<typename T>
+        inline T to_float(bool negative, adjusted_mantissa am)
+        {
+            using format = binary_format<T>;
+            using bits_type = typename format::bits_type;
+
+            uint64_t bits = am.mantissa | (static_cast<uint64_t>(am.power2) << format::mantissa_bits);
+            if (negative)
+            {
+                bits |= uint64_t(1) << (format::mantissa_bits + format::exponent_bits);
+            }
+
+            const bits_type narrow = static_cast<bits_type>(bits);
+            T result;
+            std::memcpy(&result, &narrow, sizeof(result));
+            return result;
+        }
+
+        // 128-bit truncations of 5^q for q in [-342, 308], most significant
+        // half first, each normalized so that its top bit is set.
+        inline const uint64_t * power_of_five_128()
+        {
+            static constexpr uint64_t table[] = {
+            0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL,
+            0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL,
+            0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL,
+            0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL,
+            0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL,
+            0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL,
+            0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL,
+            0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL,
+            0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL,
+            0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL,
+            0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL,
+            0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL,
+            0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL,
+            0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL,
+            0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL,
+            0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL,
+            0x84a57695fe98746dULL, 0x014bb630f7604b57ULL,
+            0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL,
+            0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL,
+            0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL,
+            0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL,
+            0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL,
+            0xfd00b897478238d0ULL, 0x8920b098955522b4ULL,
+            0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL,
+            0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL,
+            0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL,
+            0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL,
+            0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL,
+            0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL,
+            0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL,
+            0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL,
+            0xeba09271e88d976bULL, 0xf7864a44c633682eULL,
+            0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL,
+            0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL,
+            0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL,
+            0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL,
+            0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL,
+            0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL,
+            0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL,
+            0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL,
+            0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL,
+            0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL,
+            0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL,
+            0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL,
+            0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL,
+            0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL,
+            0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL,
+            0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL,
+            0xa37fce126597973cULL, 0xe50ff107bab528a0ULL,
+            0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL,
+            0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL,
+            0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL,
+            0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL,
+            0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL,
+            0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL,
+            0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL,
+            0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL,
+            0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL,
+            0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL,
+            0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL,
+            0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL,
+            0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL,
+            0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL,
+            0x91376c36d99995beULL, 0x23100809b9c21fa1ULL,
+            0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL,
+            0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL,
+            0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL,
+            0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL,
+            0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL,
+            0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL,
+            0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL,
+            0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL,
+            0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL,
+            0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL,
+            0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL,
+            0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL,
+            0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL,
+            0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL,
+            0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL,
+            0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL,
+            0xc987434744ac874eULL, 0xa327ffb266b56220ULL,
+            0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL,
+            0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL,
+            0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL,
+            0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL,
+            0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL,
+            0xc0314325637a1939ULL, 0xfa911155fefb5308ULL,
+            0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL,
+            0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL,
+            0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL,
+            0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL,
+            0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL,
+            0xb749faed14125d36ULL, 0xcef980ec671f667bULL,
+            0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL,
+            0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL,
+            0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL,
+            0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL,
+            0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL,
+            0xaecc49914078536dULL, 0x58fae9f773886e18ULL,
+            0xda7f5bf590966848ULL, 0xaf39a475506a899eULL,
+            0x888f99797a5e012dULL, 0x6d8406c952429603ULL,
+            0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL,
+            0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL,
+            0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL,
+            0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL,
+            0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL,
+            0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL,
+            0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL,
+            0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL,
+            0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL,
+            0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL,
+            0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL,
+            0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL,
+            0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL,
+            0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL,
+            0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL,
+            0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL,
+            0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL,
+            0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL,
+            0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL,
+            0xb913179899f68584ULL, 0x28e2557b59846e3fULL,
+            0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL,
+            0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL,
+            0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL,
+            0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL,
+            0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL,
+            0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL,
+            0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL,
+            0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL,
+            0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL,
+            0xd77485cb25823ac7ULL, 0x7d633293366b828bULL,
+            0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL,
+            0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL,
+            0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL,
+            0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL,
+            0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL,
+            0xcd795be870516656ULL, 0x67902e276c921f8bULL,
+            0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL,
+            0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL,
+            0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL,
+            0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL,
+            0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL,
+            0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL,
+            0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL,
+            0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL,
+            0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL,
+            0xef340a98172aace4ULL, 0x86fb897116c87c34ULL,
+            0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL,
+            0xbae0a846d2195712ULL, 0x8974836059cca109ULL,
+            0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL,
+            0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL,
+            0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL,
+            0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL,
+            0x8e938662882af53eULL, 0x547eb47b7282ee9cULL,
+            0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL,
+            0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL,
+            0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL,
+            0xae0b158b4738705eULL, 0x9624ab50b148d445ULL,
+            0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL,
+            0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL,
+            0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL,
+            0xd47487cc8470652bULL, 0x7647c3200069671fULL,
+            0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL,
+            0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL,
+            0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL,
+            0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL,
+            0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL,
+            0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL,
+            0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL,
+            0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL,
+            0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL,
+            0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL,
+            0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL,
+            0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL,
+            0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL,
+            0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL,
+            0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL,
+            0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL,
+            0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL,
+            0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL,
+            0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL,
+            0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL,
+            0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL,
+            0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL,
+            0x8c974f7383725573ULL, 0x1e414218c73a13fbULL,
+            0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL,
+            0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL,
+            0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL,
+            0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL,
+            0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL,
+            0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL,
+            0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL,
+            0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL,
+            0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL,
+            0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL,
+            0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL,
+            0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL,
+            0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL,
+            0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL,
+            0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL,
+            0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL,
+            0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL,
+            0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL,
+            0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL,
+            0xbe89523386091465ULL, 0xf6bbb397f1135823ULL,
+            0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL,
+            0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL,
+            0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL,
+            0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL,
+            0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL,
+            0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL,
+            0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL,
+            0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL,
+            0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL,
+            0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL,
+            0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL,
+            0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL,
+            0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL,
+            0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL,
+            0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL,
+            0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL,
+            0x843610cb4bf160cbULL, 0xcedf722a585139baULL,
+            0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL,
+            0xce947a3da6a9273eULL, 0x733d226229feea32ULL,
+            0x811ccc668829b887ULL, 0x0806357d5a3f525fULL,
+            0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL,
+            0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL,
+            0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL,
+            0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL,
+            0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL,
+            0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL,
+            0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL,
+            0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL,
+            0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL,
+            0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL,
+            0xbbe226efb628afeaULL, 0x890489f70a55368bULL,
+            0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL,
+            0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL,
+            0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL,
+            0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL,
+            0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL,
+            0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL,
+            0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL,
+            0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL,
+            0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL,
+            0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL,
+            0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL,
+            0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL,
+            0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL,
+            0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL,
+            0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL,
+            0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL,
+            0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL,
+            0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL,
+            0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL,
+            0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL,
+            0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL,
+            0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL,
+            0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL,
+            0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL,
+            0xc24452da229b021bULL, 0xfbe85badce996168ULL,
+            0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL,
+            0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL,
+            0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL,
+            0xed246723473e3813ULL, 0x290123e9aab23b68ULL,
+            0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL,
+            0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL,
+            0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL,
+            0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL,
+            0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL,
+            0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL,
+            0x8d590723948a535fULL, 0x579c487e5a38ad0eULL,
+            0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL,
+            0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL,
+            0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL,
+            0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL,
+            0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL,
+            0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL,
+            0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL,
+            0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+            0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL,
+            0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+            0xcdb02555653131b6ULL, 0x3792f412cb06794dULL,
+            0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+            0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL,
+            0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+            0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL,
+            0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+            0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL,
+            0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+            0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL,
+            0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+            0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL,
+            0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+            0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL,
+            0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+            0x9226712162ab070dULL, 0xcab3961304ca70e8ULL,
+            0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+            0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL,
+            0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+            0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL,
+            0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+            0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL,
+            0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+            0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL,
+            0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+            0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL,
+            0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+            0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL,
+            0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+            0xcfb11ead453994baULL, 0x67de18eda5814af2ULL,
+            0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+            0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL,
+            0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+            0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL,
+            0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+            0xc612062576589ddaULL, 0x95364afe032a819eULL,
+            0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+            0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL,
+            0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+            0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL,
+            0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+            0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL,
+            0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+            0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL,
+            0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+            0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL,
+            0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+            0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL,
+            0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+            0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL,
+            0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+            0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL,
+            0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+            0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL,
+            0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+            0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL,
+            0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+            0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL,
+            0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+            0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL,
+            0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+            0x8000000000000000ULL, 0x0000000000000000ULL,
+            0xa000000000000000ULL, 0x0000000000000000ULL,
+            0xc800000000000000ULL, 0x0000000000000000ULL,
+            0xfa00000000000000ULL, 0x0000000000000000ULL,
+            0x9c40000000000000ULL, 0x0000000000000000ULL,
+            0xc350000000000000ULL, 0x0000000000000000ULL,
+            0xf424000000000000ULL, 0x0000000000000000ULL,
+            0x9896800000000000ULL, 0x0000000000000000ULL,
+            0xbebc200000000000ULL, 0x0000000000000000ULL,
+            0xee6b280000000000ULL, 0x0000000000000000ULL,
+            0x9502f90000000000ULL, 0x0000000000000000ULL,
+            0xba43b74000000000ULL, 0x0000000000000000ULL,
+            0xe8d4a51000000000ULL, 0x0000000000000000ULL,
+            0x9184e72a00000000ULL, 0x0000000000000000ULL,
+            0xb5e620f480000000ULL, 0x0000000000000000ULL,
+            0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+            0x8e1bc9bf04000000ULL, 0x0000000000000000ULL,
+            0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+            0xde0b6b3a76400000ULL, 0x0000000000000000ULL,
+            0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+            0xad78ebc5ac620000ULL, 0x0000000000000000ULL,
+            0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+            0x878678326eac9000ULL, 0x0000000000000000ULL,
+            0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+            0xd3c21bcecceda100ULL, 0x0000000000000000ULL,
+            0x84595161401484a0ULL, 0x0000000000000000ULL,
+            0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL,
+            0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+            0x813f3978f8940984ULL, 0x4000000000000000ULL,
+            0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+            0xc9f2c9cd04674edeULL, 0xa400000000000000ULL,
+            0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+            0x9dc5ada82b70b59dULL, 0xf020000000000000ULL,
+            0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+            0xf684df56c3e01bc6ULL, 0xc732000000000000ULL,
+            0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+            0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL,
+            0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+            0x96769950b50d88f4ULL, 0x1314448000000000ULL,
+            0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+            0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL,
+            0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL,
+            0xb7abc627050305adULL, 0xf14a3d9e40000000ULL,
+            0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL,
+            0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL,
+            0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL,
+            0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL,
+            0x8c213d9da502de45ULL, 0x4526f422cc340000ULL,
+            0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL,
+            0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL,
+            0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL,
+            0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL,
+            0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL,
+            0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL,
+            0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL,
+            0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL,
+            0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL,
+            0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL,
+            0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL,
+            0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL,
+            0x9f4f2726179a2245ULL, 0x01d762422c946590ULL,
+            0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL,
+            0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL,
+            0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL,
+            0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL,
+            0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL,
+            0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL,
+            0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL,
+            0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL,
+            0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL,
+            0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL,
+            0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL,
+            0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL,
+            0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL,
+            0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL,
+            0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL,
+            0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL,
+            0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL,
+            0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL,
+            0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL,
+            0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL,
+            0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL,
+            0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL,
+            0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL,
+            0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL,
+            0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL,
+            0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL,
+            0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL,
+            0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL,
+            0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL,
+            0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL,
+            0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL,
+            0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL,
+            0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL,
+            0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL,
+            0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL,
+            0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL,
+            0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL,
+            0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL,
+            0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL,
+            0x924d692ca61be758ULL, 0x593c2626705f9c56ULL,
+            0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL,
+            0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL,
+            0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL,
+            0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL,
+            0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL,
+            0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL,
+            0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL,
+            0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL,
+            0x884134fe908658b2ULL, 0x3109058d147fdcddULL,
+            0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL,
+            0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL,
+            0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL,
+            0xa6539930bf6bff45ULL, 0x84db8346b786151cULL,
+            0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL,
+            0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL,
+            0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL,
+            0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL,
+            0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL,
+            0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL,
+            0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL,
+            0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL,
+            0x9ae757596946075fULL, 0x3375788de9b06958ULL,
+            0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL,
+            0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL,
+            0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL,
+            0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL,
+            0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL,
+            0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL,
+            0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL,
+            0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL,
+            0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL,
+            0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL,
+            0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL,
+            0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL,
+            0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL,
+            0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL,
+            0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL,
+            0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL,
+            0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL,
+            0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL,
+            0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL,
+            0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL,
+            0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL,
+            0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL,
+            0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL,
+            0x802221226be55a64ULL, 0xc2494954da2c9789ULL,
+            0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL,
+            0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL,
+            0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL,
+            0x9c69a97284b578d7ULL, 0xff2a760414536efbULL,
+            0xc38413cf25e2d70dULL, 0xfef5138519684abaULL,
+            0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL,
+            0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL,
+            0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL,
+            0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL,
+            0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL,
+            0xba756174393d88dfULL, 0x94f971119aeef9e4ULL,
+            0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL,
+            0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL,
+            0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL,
+            0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL,
+            0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL,
+            0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL,
+            0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL,
+            0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL,
+            0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL,
+            0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL,
+            0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL,
+            0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL,
+            0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL,
+            0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL,
+            0xa59bc234db398c25ULL, 0x43fab9837e699095ULL,
+            0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL,
+            0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL,
+            0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL,
+            0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL,
+            0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL,
+            0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL,
+            0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL,
+            0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL,
+            0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL,
+            0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL,
+            0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL,
+            0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL,
+            0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL,
+            0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL,
+            0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL,
+            0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL,
+            0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL,
+            0x8fa475791a569d10ULL, 0xf96e017d694487bcULL,
+            0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL,
+            0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL,
+            0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL,
+            0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL,
+            0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL,
+            0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL,
+            0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL,
+            0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL,
+            0x85c7056562757456ULL, 0xf6872d5667844e49ULL,
+            0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL,
+            0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL,
+            0x82a45b450226b39cULL, 0xecc0024661173473ULL,
+            0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL,
+            0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL,
+            0xff290242c83396ceULL, 0x7e67047175a15271ULL,
+            0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL,
+            0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL,
+            0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL,
+            0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL,
+            0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL,
+            0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL,
+            0x98165af37b2153deULL, 0xc3727a337a8b704aULL,
+            0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL,
+            0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL,
+            0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL,
+            0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL,
+            0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL,
+            0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL,
+            0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL,
+            0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL,
+            0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL,
+            0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL,
+            0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL,
+            0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL,
+            0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL,
+            0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL,
+            0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL,
+            0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL,
+            0xd31045a8341ca07cULL, 0x1ede48111209a050ULL,
+            0x83ea2b892091e44dULL, 0x934aed0aab460432ULL,
+            0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL,
+            0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL,
+            0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL,
+            0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL,
+            0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL,
+            0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL,
+            0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL,
+            0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL,
+            0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL,
+            0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL,
+            0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL,
+            0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL,
+            0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL,
+            0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL,
+            0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL,
+            0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL,
+            0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL,
+            0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL,
+            0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL,
+            0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL,
+            0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL,
+            0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL,
+            0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL,
+            0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL,
+            0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL,
+            0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL,
+            0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL,
+            0x8533285c936b35deULL, 0xd53a88958f87275fULL,
+            0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL,
+            0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL,
+            0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL,
+            0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL,
+            0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL,
+            0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL,
+            0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL,
+            0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL,
+            0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL,
+            0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL,
+            0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL,
+            0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL,
+            0x976e41088617ca01ULL, 0xd5be0503e085d813ULL,
+            0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL,
+            0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL,
+            0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL,
+            0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL,
+            0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL,
+            0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL,
+            0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL,
+            0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL,
+            0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL,
+            0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL,
+            0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL,
+            0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL,
+            0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL,
+            0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL,
+            0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL,
+            0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL,
+            0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL,
+            0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL,
+            0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL,
+            0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL,
+            0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL,
+            0xa0555e361951c366ULL, 0xd7e105bcc332621fULL,
+            0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL,
+            0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL,
+            0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL,
+            0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL,
+            0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL,
+            0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL,
+            0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL,
+            0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL,
+            0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL,
+            0xbaa718e68396cffdULL, 0xd30560258f54e6baULL,
+            0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL,
+            0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL,
+            0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL,
+            0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL,
+            0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL
+            };
+            return table;
+        }
+
+        template<typename T>
+        inline adjusted_mantissa eisel_lemire(int64_t q, uint64_t w)
+        {
+            using format = binary_format<T>;
+            adjusted_mantissa answer;
+
+            if (w == 0 || q < format::smallest_power_of_ten)
+            {
+                return answer;
+            }
+            if (q > format::largest_power_of_ten)
+            {
+                answer.power2 = format::infinite_power;
+                return answer;
+            }
+
+            const int lz = static_cast<int>(count_leading_zeros(w));
+            w <<= lz;
+
+            // Approximate w * 5^q with a 64-bit truncated product, refined with
+            // the second half of the power when the truncation could matter.
+            const uint64_t * powers = power_of_five_128();
+            const size_t index = 2 * static_cast<size_t>(q + 342);
+            uint64_t high = 0;
+            uint64_t low  = multiply_64x64(w, powers[index], high);
+
+            constexpr uint64_t precision_mask = ~uint64_t(0) >> (format::mantissa_bits + 3);
+            if ((high & precision_mask) == precision_mask)
+            {
+                uint64_t second_high = 0;
+                multiply_64x64(w, powers[index + 1], second_high);
+                low += second_high;
+                if (second_high > low)
+                {
+                    ++high;
+                }
+            }
+
+            const int upperbit = static_cast<int>(high >> 63);
+            const int shift    = upperbit + 64 - format::mantissa_bits - 3;
+            answer.mantissa = high >> shift;
+
+            // floor(log2(10^q)) + 63, computed without floating point.
+            const int power = static_cast<int>(((152170 + 65536) * q) >> 16) + 63;
+            answer.power2 = power + upperbit - lz - format::minimum_exponent;
+
+            if (answer.power2 <= 0)
+            {
+                // Subnormal, or zero if everything is shifted out.
+                if (-answer.power2 + 1 >= 64)
+                {
+                    return adjusted_mantissa();
+                }
+                answer.mantissa >>= -answer.power2 + 1;
+                answer.mantissa += (answer.mantissa & 1);
+                answer.mantissa >>= 1;
+                answer.power2 = (answer.mantissa < (uint64_t(1) << format::mantissa_bits)) ? 0 : 1;
+                return answer;
+            }
+
+            // Exactly halfway between two floats: round to even instead of up.
+            if (low <= 1 && q >= format::min_exponent_round_to_even && q <= format::max_exponent_round_to_even &&
+                (answer.mantissa & 3) == 1 && (answer.mantissa << shift) == high)
+            {
+                answer.mantissa &= ~uint64_t(1);
+            }
+
+            answer.mantissa += (answer.mantissa & 1);
+            answer.mantissa >>= 1;
+            if (answer.mantissa >= (uint64_t(2) << format::mantissa_bits))
+            {
+                answer.mantissa = uint64_t(1) << format::mantissa_bits;
+                ++answer.power2;
+            }
+
+            answer.mantissa &= ~(uint64_t(1) << format::mantissa_bits);
+            if (answer.power2 >= format::infinite_power)
+            {
+                answer.power2   = format::infinite_power;
+                answer.mantissa = 0;
+            }
+            return answer;
+        }
+
+        // Arbitrary-precision decimal used when Eisel-Lemire cannot decide
+        // (the simple decimal conversion algorithm from Go's strconv).
+        class big_decimal
+        {
+        public:
+            static constexpr int max_digits = 800;
+
+            void push_integer_digit(uint8_t digit)
+            {
+                if (nd_ == 0 && digit == 0)
+                {
+                    return;
+                }
+                push(digit);
+                ++dp_;
+            }
+
+            void push_fraction_digit(uint8_t digit)
+            {
+                if (nd_ == 0 && digit == 0)
+                {
+                    --dp_;
+                    return;
+                }
+                push(digit);
+            }
+
+            void add_exponent(int64_t exponent)
+            {
+                dp_ = static_cast<int>(std::max<int64_t>(-100000, std::min<int64_t>(100000, dp_ + exponent)));
+                trim();
+            }
+
+            template<typename T>
+            adjusted_mantissa to_binary()
+            {
+                using format = binary_format<T>;
+                constexpr int bias = format::minimum_exponent;
+                constexpr int powtab[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+                const adjusted_mantissa infinity { 0, format::infinite_power };
+
+                if (nd_ == 0 || dp_ < -330)
+                {
+                    return adjusted_mantissa();
+                }
+                if (dp_ > 310)
+                {
+                    return infinity;
+                }
+
+                // Scale by powers of two into [0.5, 1).
+                int exp = 0;
+                while (dp_ > 0)
+                {
+                    const int n = dp_ >= 9 ? 27 : powtab[dp_];
+                    shift(-n);
+                    exp += n;
+                }
+                while (dp_ < 0 || (dp_ == 0 && digits_[0] < 5))
+                {
+                    const int n = -dp_ >= 9 ? 27 : powtab[-dp_];
+                    shift(n);
+                    exp -= n;
+                }
+
+                // [0.5, 1) -> [1, 2), then move subnormals up to the minimum exponent.
+                --exp;
+                if (exp < bias + 1)
+                {
+                    const int n = bias + 1 - exp;
+                    shift(-n);
+                    exp += n;
+                }
+                if (exp - bias >= (1 << format::exponent_bits) - 1)
+                {
+                    return infinity;
+                }
+
+                shift(1 + format::mantissa_bits);
+                uint64_t mant = rounded_integer();
+                if (mant == (uint64_t(2) << format::mantissa_bits))
+                {
+                    mant >>= 1;
+                    ++exp;
+                    if (exp - bias >= (1 << format::exponent_bits) - 1)
+                    {
+                        return infinity;
+                    }
+                }
+                if ((mant & (uint64_t(1) << format::mantissa_bits)) == 0)
+                {
+                    exp = bias;
+                }
+
+                return { mant & ((uint64_t(1) << format::mantissa_bits) - 1), exp - bias };
+            }
+
+        private:
+            static constexpr unsigned max_shift = 60;
+
+            void push(uint8_t digit)
+            {
+                if (nd_ < max_digits)
+                {
+                    digits_[nd_++] = digit;
+                }
+                else if (digit != 0)
+                {
+                    truncated_ = true;
+                }
+            }
+
+            void trim()
+            {
+                while (nd_ > 0 && digits_[nd_ - 1] == 0)
+                {
+                    --nd_;
+                }
+                if (nd_ == 0)
+                {
+                    dp_ = 0;
+                }
+            }
+
+            void shift(int k)
+            {
+                if (nd_ == 0)
+                {
+                    return;
+                }
+                for (; k > static_cast<int>(max_shift); k -= max_shift)
+                {
+                    left_shift(max_shift);
+                }
+                for (; k < -static_cast<int>(max_shift); k += max_shift)
+                {
+                    right_shift(max_shift);
+                }
+                if (k > 0)
+                {
+                    left_shift(static_cast<unsigned>(k));
+                }
+                else if (k < 0)
+                {
+                    right_shift(static_cast<unsigned>(-k));
+                }
+            }
+
+            // Multiplies by 2^k, k <= max_shift.
+            void left_shift(unsigned k)
+            {
+                uint8_t product[max_digits + 20];
+                const int end = nd_ + 20;
+                int w = end;
+
+                uint64_t n = 0;
+                for (int r = nd_ - 1; r >= 0; --r)
+                {
+                    n += static_cast<uint64_t>(digits_[r]) << k;
+                    const uint64_t quotient = n / 10;
+                    product[--w] = static_cast<uint8_t>(n - 10 * quotient);
+                    n = quotient;
+                }
+                while (n > 0)
+                {
+                    const uint64_t quotient = n / 10;
+                    product[--w] = static_cast<uint8_t>(n - 10 * quotient);
+                    n = quotient;
+                }
+
+                const int new_nd = end - w;
+                const int kept   = std::min(new_nd, static_cast<int>(max_digits));
+                std::memcpy(digits_, product + w, static_cast<size_t>(kept));
+                for (int i = kept; i < new_nd; ++i)
+                {
+                    truncated_ = truncated_ || product[w + i] != 0;
+                }
+
+                dp_ += new_nd - nd_;
+                nd_  = kept;
+                trim();
+            }
+
+            // Divides by 2^k, k <= max_shift.
+            void right_shift(unsigned k)
+            {
+                int r = 0;
+                int w = 0;
+
+                uint64_t n = 0;
+                for (; (n >> k) == 0; ++r)
+                {
+                    if (r >= nd_)
+                    {
+                        if (n == 0)
+                        {
+                            nd_ = 0;
+                            return;
+                        }
+                        while ((n >> k) == 0)
+                        {
+                            n *= 10;
+                            ++r;
+                        }
+                        break;
+                    }
+                    n = n * 10 + digits_[r];
+                }
+                dp_ -= r - 1;
+
+                const uint64_t mask = (uint64_t(1) << k) - 1;
+                for (; r < nd_; ++r)
+                {
+                    const uint64_t digit = n >> k;
+                    n &= mask;
+                    digits_[w++] = static_cast<uint8_t>(digit);
+                    n = n * 10 + digits_[r];
+                }
+                while (n > 0)
+                {
+                    const uint64_t digit = n >> k;
+                    n &= mask;
+                    if (w < max_digits)
+                    {
+                        digits_[w++] = static_cast<uint8_t>(digit);
+                    }
+                    else if (digit > 0)
+                    {
+                        truncated_ = true;
+                    }
+                    n *= 10;
+                }
+
+                nd_ = w;
+                trim();
+            }
+
+            bool should_round_up(int nd) const
+            {
+                if (nd < 0 || nd >= nd_)
+                {
+                    return false;
+                }
+                if (digits_[nd] == 5 && nd + 1 == nd_)
+                {
+                    // Exactly halfway unless digits were dropped: round to even.
+                    return truncated_ || (nd > 0 && digits_[nd - 1] % 2 == 1);
+                }
+                return digits_[nd] >= 5;
+            }
+
+            uint64_t rounded_integer() const
+            {
+                if (dp_ > 20)
+                {
+                    return ~uint64_t(0);
+                }
+
+                uint64_t n = 0;
+                int i = 0;
+                for (; i < dp_ && i < nd_; ++i)
+                {
+                    n = n * 10 + digits_[i];
+                }
+                for (; i < dp_; ++i)
+                {
+                    n *= 10;
+                }
+                return should_round_up(dp_) ? n + 1 : n;
+            }
+
+            uint8_t digits_[max_digits];
+            int     nd_        = 0;
+            int     dp_        = 0;
+            bool    truncated_ = false;
+        };
+
+        // Rounds mantissa * 2^exponent (plus a sticky fraction below the
+        // mantissa if sticky is set) to the nearest T, ties to even.
+        template<typename T>
+        inline adjusted_mantissa round_binary(uint64_t mantissa, int64_t exponent, bool sticky)
+        {
+            using format = binary_format<T>;
+            if (mantissa == 0)
+            {
+                return adjusted_mantissa();
+            }
+
+            const unsigned lz = count_leading_zeros(mantissa);
+            mantissa <<= lz;
+            exponent -= lz;
+
+            // Unbiased exponent of the leading bit.
+            const int64_t leading = exponent + 63;
+            const int64_t bias    = -format::minimum_exponent;
+            if (leading > bias)
+            {
+                return { 0, format::infinite_power };
+            }
+
+            int64_t shift = 63 - format::mantissa_bits;
+            if (leading < 1 - bias)
+            {
+                shift += (1 - bias) - leading;
+            }
+            if (shift > 64)
+            {
+                return adjusted_mantissa();
+            }
+
+            uint64_t kept      = shift == 64 ? 0 : mantissa >> shift;
+            const uint64_t rem = shift == 64 ? mantissa : mantissa & ((uint64_t(1) << shift) - 1);
+            const uint64_t half = uint64_t(1) << (shift - 1);
+            if (rem > half || (rem == half && (sticky || (kept & 1))))
+            {
+                ++kept;
+            }
+
+            int64_t power2 = leading < 1 - bias ? 0 : leading + bias;
+            if (kept == (uint64_t(2) << format::mantissa_bits))
+            {
+                kept >>= 1;
+                ++power2;
+            }
+            else if (power2 == 0 && kept == (uint64_t(1) << format::mantissa_bits))
+            {
+                // A subnormal rounded up to the smallest normal.
+                power2 = 1;
+            }
+            if (power2 >= format::infinite_power)
+            {
+                return { 0, format::infinite_power };
+            }
+
+            return { kept & ((uint64_t(1) << format::mantissa_bits) - 1), static_cast<int>(power2) };
+        }
+
+        inline bool is_digit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        inline int hex_digit_value(char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        }
+
+        // Case-insensitive match of an ASCII lower-case word at the start of [first, last).
+        inline bool starts_with_word(const char * first, const char * last, std::string_view word)
+        {
+            if (static_cast<size_t>(last - first) < word.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < word.size(); ++i)
+            {
+                if ((first[i] | 0x20) != word[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Parses an optional binary or decimal exponent ("p-3", "e+10") at p.
+        // Returns p unchanged if no complete exponent is present.
+        inline const char * parse_exponent(const char * p, const char * last, char marker, int64_t & exponent)
+        {
+            if (p == last || (*p | 0x20) != marker)
+            {
+                return p;
+            }
+
+            const char * q = p + 1;
+            bool negative = false;
+            if (q != last && (*q == '+' || *q == '-'))
+            {
+                negative = (*q == '-');
+                ++q;
+            }
+            if (q == last || !is_digit(*q))
+            {
+                return p;
+            }
+
+            int64_t value = 0;
+            for (; q != last && is_digit(*q); ++q)
+            {
+                if (value < 0x10000000)
+                {
+                    value = value * 10 + (*q - '0');
+                }
+            }
+            exponent = negative ? -value : value;
+            return q;
+        }
+
+        template<typename T>
+        struct float_parse
+        {
+            T            value{};
+            const char * end = nullptr;   // == first if nothing could be parsed
+        };
+
+        template<typename T>
+        inline float_parse<T> parse_hex_float(const char * first, const char * last, bool negative)
+        {
+            // first points just past "0x".
+            uint64_t mantissa = 0;
+            int64_t  exponent = 0;
+            bool     sticky   = false;
+            bool     any      = false;
+
+            const char * p = first;
+            for (; p != last && hex_digit_value(*p) >= 0; ++p, any = true)
+            {
+                if (mantissa >> 60 == 0)
+                {
+                    mantissa = (mantissa << 4) | static_cast<uint64_t>(hex_digit_value(*p));
+                }
+                else
+                {
+                    sticky = sticky || *p != '0';
+                    exponent += 4;
+                }
+            }
+            if (p != last && *p == '.')
+            {
+                for (++p; p != last && hex_digit_value(*p) >= 0; ++p, any = true)
+                {
+                    if (mantissa >> 60 == 0)
+                    {
+                        mantissa = (mantissa << 4) | static_cast<uint64_t>(hex_digit_value(*p));
+                        exponent -= 4;
+                    }
+                    else
+                    {
+                        sticky = sticky || *p != '0';
+                    }
+                }
+            }
+            if (!any)
+            {
+                return { T{}, nullptr };
+            }
+
+            int64_t binary_exponent = 0;
+            p = parse_exponent(p, last, 'p', binary_exponent);
+
+            if (mantissa == 0)
+            {
+                return { negative ? -T(0) : T(0), p };
+            }
+            return { to_float<T>(negative, round_binary<T>(mantissa, exponent + binary_exponent, sticky)), p };
+        }
+
+        template<typename T>
+        inline float_parse<T> parse_float(const char * const first, const char * const last)
+        {
+            using format = binary_format<T>;
+
+            const char * p = first;
+            bool negative = false;
+            if (p != last && (*p == '+' || *p == '-'))
+            {
+                negative = (*p == '-');
+                ++p;
+            }
+
+            if (p != last && ((*p | 0x20) == 'i' || (*p | 0x20) == 'n'))
+            {
+                if (starts_with_word(p, last, "inf"))
+                {
+                    const T infinity = std::numeric_limits<T>::infinity();
+                    return { negative ? -infinity : infinity, p + (starts_with_word(p, last, "infinity") ? 8 : 3) };
+                }
+                if (starts_with_word(p, last, "nan"))
+                {
+                    p += 3;
+                    if (p != last && *p == '(')
+                    {
+                        const char * q = p + 1;
+                        while (q != last && (is_digit(*q) || ((*q | 0x20) >= 'a' && (*q | 0x20) <= 'z') || *q == '_'))
+                        {
+                            ++q;
+                        }
+                        if (q != last && *q == ')')
+                        {
+                            p = q + 1;
+                        }
+                    }
+                    const T nan = std::numeric_limits<T>::quiet_NaN();
+                    return { negative ? -nan : nan, p };
+                }
+                return { T{}, first };
+            }
+
+            if (last - p >= 2 && p[0] == '0' && (p[1] | 0x20) == 'x')
+            {
+                const auto hex = parse_hex_float<T>(p + 2, last, negative);
+                if (hex.end != nullptr)
+                {
+                    return hex;
+                }
+                // "0x" without hex digits: only the "0" is a number.
+            }
+
+            // Decimal: first 19 significant digits into w, value = w * 10^exponent.
+            const char * const integer_begin = p;
+            while (p != last && is_digit(*p))
+            {
+                ++p;
+            }
+            const char * const integer_end = p;
+            const char * fraction_begin = p;
+            const char * fraction_end   = p;
+            if (p != last && *p == '.')
+            {
+                fraction_begin = ++p;
+                while (p != last && is_digit(*p))
+                {
+                    ++p;
+                }
+                fraction_end = p;
+            }
+            if (integer_begin == integer_end && fraction_begin == fraction_end)
+            {
+                return { T{}, first };
+            }
+
+            int64_t explicit_exponent = 0;
+            p = parse_exponent(p, last, 'e', explicit_exponent);
+
+            uint64_t w = 0;
+            int64_t  exponent = explicit_exponent;
+            int      significant = 0;
+            bool     truncated   = false;
+            for (const char * d = integer_begin; d != integer_end; ++d)
+            {
+                if (significant == 0 && *d == '0')
+                {
+                    continue;
+                }
+                if (significant < 19)
+                {
+                    w = w * 10 + static_cast<uint64_t>(*d - '0');
+                    ++significant;
+                }
+                else
+                {
+                    ++exponent;
+                    truncated = truncated || *d != '0';
+                }
+            }
+            for (const char * d = fraction_begin; d != fraction_end; ++d)
+            {
+                if (significant == 0 && *d == '0')
+                {
+                    --exponent;
+                    continue;
+                }
+                if (significant < 19)
+                {
+                    w = w * 10 + static_cast<uint64_t>(*d - '0');
+                    ++significant;
+                    --exponent;
+                }
+                else
+                {
+                    truncated = truncated || *d != '0';
+                }
+            }
+
+            // Clinger: both operands exact, so a single rounding is correct.
+            // Requires arithmetic in the type's own precision (not x87).
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+            if (!truncated && w <= format::max_mantissa_fast_path &&
+                exponent >= -format::max_exponent_fast_path && exponent <= format::max_exponent_fast_path)
+            {
+                T value = static_cast<T>(w);
+                value = exponent < 0 ? value / format::exact_power_of_ten(static_cast<int>(-exponent))
+                                     : value * format::exact_power_of_ten(static_cast<int>(exponent));
+                return { negative ? -value : value, p };
+            }
+#endif
+
+            adjusted_mantissa am = eisel_lemire<T>(exponent, w);
+            if (truncated && am != eisel_lemire<T>(exponent, w + 1))
+            {
+                big_decimal decimal;
+                for (const char * d = integer_begin; d != integer_end; ++d)
+                {
+                    decimal.push_integer_digit(static_cast<uint8_t>(*d - '0'));
+                }
+                for (const char * d = fraction_begin; d != fraction_end; ++d)
+                {
+                    decimal.push_fraction_digit(static_cast<uint8_t>(*d - '0'));
+                }
+                decimal.add_exponent(explicit_exponent);
+                am = decimal.to_binary<T>();
+            }
+
+            return { to_float<T>(negative, am), p };
+        }
+
+        template<>
+        inline float_parse<long double> parse_float<long double>(const char * const first, const char * const last)
+        {
+            if constexpr (std::numeric_limits<long double>::digits == std::numeric_limits<double>::digits)
+            {
+                const auto parsed = parse_float<double>(first, last);
+                return { static_cast<long double>(parsed.value), parsed.end };
+            }
+            else
+            {
+                // Wider formats have no dedicated engine: let the double scanner
+                // validate the literal, then hand exactly that span to strtold
+                // with the decimal point spelled the way the current locale expects.
+                const auto span = parse_float<double>(first, last);
+                if (span.end == first)
+                {
+                    return { 0.0L, first };
+                }
+
+                const char * const point = std::localeconv()->decimal_point;
+                std::string buffer;
+                buffer.reserve(static_cast<size_t>(span.end - first) + 4);
+                for (const char * c = first; c != span.end; ++c)
+                {
+                    if (*c == '.')
+                    {
+                        buffer += point;
+                    }
+                    else
+                    {
+                        buffer += *c;
+                    }
+                }
+                return { std::strtold(buffer.c_str(), nullptr), span.end };
+            }
+        }
+    }
+
+    /**
+     * @brief Parses a number from the beginning of str without allocating and
+     *        independently of the global locale. Leading white space and a
+     *        single leading '+' are skipped, like stream extraction does.
+     *        Integers are parsed in base 10 with std::from_chars; bool accepts
+     *        "0" and "1" only. Negative input for unsigned types is an error.
+     *        Floating-point types accept the strtod syntax (decimal, hex,
+     *        inf/infinity, nan) with '.' as the decimal point, are correctly
+     *        rounded, and fail with result_out_of_range on overflow.
+     *        Exception: where long double is wider than double, long double
+     *        has no dedicated engine; the validated span is copied into a
+     *        temporary std::string, its '.' replaced by the decimal point of
+     *        the current C locale, and converted with std::strtold.
+     * @tparam T - arithmetic, non-character type.
+     * @param str - std::string_view to parse.
+     * @param strict - if false (default), trailing characters after the number
+     *                 are ignored; if true, they make the parse fail with
+     *                 pos pointing at the first of them.
+     * @return parse_result with the value, stop position and error code.
+     */
+    template<typename T>
+    inline parse_result<T> parse_number(std::string_view str, bool strict = false)
+    {
+        static_assert(detail::is_parsable_number_v<T>, "parse_number requires an arithmetic, non-character type");
+
+        parse_result<T> result;
+        const char * const begin = str.data();
+        const char * const last  = begin + str.size();
+
+        const char * first = begin;
+        while (first != last && detail::is_space(*first))
+        {
+            ++first;
+        }
+
+        const char * end = first;
+        std::errc ec{};
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            const auto parsed = detail::parse_float<T>(first, last);
+            end = parsed.end;
+            if (end == first)
+            {
+                ec = std::errc::invalid_argument;
+            }
+            else
+            {
+                result.value = parsed.value;
+
+                // A finite literal that rounds to infinity does not fit into T.
+                const char * digits = (*first == '+' || *first == '-') ? first + 1 : first;
+                if (std::isinf(result.value) && !detail::starts_with_word(digits, end, "inf"))
+                {
+                    ec = std::errc::result_out_of_range;
+                }
+            }
+        }
+        else
+        {
+            if (last - first >= 2 && *first == '+' && *(first + 1) >= '0' && *(first + 1) <= '9')
+            {
+                ++first;
+            }
+
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                unsigned value = 0;
+                const auto parsed = std::from_chars(first, last, value);
+                end = parsed.ptr;
+                ec  = parsed.ec;
+                if (ec == std::errc{} && value > 1)
+                {
+                    ec = std::errc::invalid_argument;
+                }
+                result.value = (value == 1);
+            }
+            else
+            {
+                const auto parsed = std::from_chars(first, last, result.value);
+                end = parsed.ptr;
+                ec  = parsed.ec;
+            }
+        }
+
+        if (ec == std::errc{} && strict && end != last)
+        {
+            ec = std::errc::invalid_argument;
+        }
+
+        if (ec != std::errc{})
+        {
+            result.value = T{};
+            result.ec    = ec;
+        }
+        result.pos = static_cast<size_t>(end - begin);
+
+        return result;
+    }
+
+    /**
+     * @brief Converts std::string into any datatype.
+     *        Datatype must support >> operator.
+     *        On parse failure the result is value-initialized (e.g. 0 for
+     *        arithmetic types, false for bool). Use try_parse_string if you
+     *        need to distinguish failure from a legitimate zero/default value.
+     *        Arithmetic types (except character types) are parsed by
+     *        parse_number, without a stream and independently of the locale;
+     *        trailing non-numeric characters (e.g. "5.245f") are ignored and
+     *        out-of-range values are parse failures.
+     * @tparam T
+     * @param str - std::string_view that will be converted into datatype T.
+     * @return Variable of datatype T, or T{} on parse failure.
+     */
+    template<typename T>
+    inline T parse_string(std::string_view str)
+    {
+        if constexpr (detail::is_parsable_number_v<T>)
+        {
+            return parse_number<T>(str).value;
+        }
+        else
+        {
+            T result{};
+            std::istringstream(std::string(str)) >> result;
+
+            return result;
+        }
+    }
+
+    /**
+     * @brief Like parse_string, but reports failure explicitly via std::optional.
+     *        Returns std::nullopt if the input could not be parsed as T.
+     *        Note: trailing junk after a valid prefix is ignored (this matches
+     *        std::istringstream semantics), e.g. try_parse_string<int>("42abc")
+     *        returns 42, not nullopt. Use parse_number with strict = true to
+     *        reject it instead.
+     * @tparam T
+     * @param str - std::string_view that will be converted into datatype T.
+     * @return std::optional<T> containing the parsed value, or std::nullopt on failure.
+     */
+    template<typename T>
+    inline std::optional<T> try_parse_string(std::string_view str)
+    {
+        if constexpr (detail::is_parsable_number_v<T>)
+        {
+            const auto parsed = parse_number<T>(str);
+            if (!parsed)
+            {
+                return std::nullopt;
+            }
+            return parsed.value;
+        }
+        else
+        {
+            T result{};
+            std::istringstream iss{std::string(str)};
+            iss >> result;
+            if (iss.fail())
+            {
+                return std::nullopt;
+            }
+            return result;
+        }
+    }
+
+    namespace detail
+    {
+        // Locale-independent ASCII case kernels. Converting flips bit 0x20 of
+        // every byte in [lo, lo + 25] ('A'..'Z' or 'a'..'z'); comparing folds
+        // both sides to lower case first. Bytes outside ASCII are untouched.
+
+        inline void ascii_case_scalar(char * first, char * last, char lo)
+        {
+            for (; first != last; ++first)
+            {
+                if (static_cast<unsigned char>(*first - lo) < 26)
+                {
+                    *first = static_cast<char>(*first ^ 0x20);
+                }
+            }
+        }
+
+        inline bool equal_ignore_case_scalar(const char * lhs, const char * rhs, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                const unsigned char a = static_cast<unsigned char>(lhs[i]);
+                const unsigned char b = static_cast<unsigned char>(rhs[i]);
+                if ((a | (static_cast<unsigned char>(a - 'A') < 26 ? 0x20 : 0)) !=
+                    (b | (static_cast<unsigned char>(b - 'A') < 26 ? 0x20 : 0)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+#if defined(STRUTIL_X86_SIMD)
+        // Flips the case of bytes in [lo, lo + 25]. Bytes >= 0x80 compare as
+        // negative and therefore never fall into the range.
+        inline __m128i ascii_flip_case_sse2(__m128i block, char lo)
+        {
+            const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                                                   _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(lo + 26))));
+            return _mm_xor_si128(block, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+        }
+
+        inline void ascii_case_sse2(char * first, char * last, char lo)
+        {
+            for (; last - first >= 16; first += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(first), ascii_flip_case_sse2(block, lo));
+            }
+            ascii_case_scalar(first, last, lo);
+        }
+
+        inline bool equal_ignore_case_sse2(const char * lhs, const char * rhs, size_t length)
+        {
+            for (; length >= 16; lhs += 16, rhs += 16, length -= 16)
+            {
+                const __m128i a = ascii_flip_case_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lhs)), 'A');
+                const __m128i b = ascii_flip_case_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs)), 'A');
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+                {
+                    return false;
+                }
+            }
+            return equal_ignore_case_scalar(lhs, rhs, length);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline __m256i ascii_flip_case_avx2(__m256i block, char lo)
+        {
+            const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                                                      _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(lo + 26)), block));
+            return _mm256_xor_si256(block, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline void ascii_case_avx2(char * first, char * last, char lo)
+        {
+            for (; last - first >= 32; first += 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), ascii_flip_case_avx2(block, lo));
+            }
+            ascii_case_sse2(first, last, lo);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline bool equal_ignore_case_avx2(const char * lhs, const char * rhs, size_t length)
+        {
+            for (; length >= 32; lhs += 32, rhs += 32, length -= 32)
+            {
+                const __m256i a = ascii_flip_case_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(lhs)), 'A');
+                const __m256i b = ascii_flip_case_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs)), 'A');
+                if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))) != 0xFFFFFFFFu)
+                {
+                    return false;
+                }
+            }
+            return equal_ignore_case_sse2(lhs, rhs, length);
+        }
+#endif // STRUTIL_X86_SIMD
+
+        struct case_kernels
+        {
+            void (*convert)(char *, char *, char);
+            bool (*equal)(const char *, const char *, size_t);
+        };
+
+        inline const case_kernels & case_kernels_for_cpu()
+        {
+            static const case_kernels kernels = []() -> case_kernels
+            {
+#if defined(STRUTIL_X86_SIMD)
+                if (cpu().avx2) return { ascii_case_avx2, equal_ignore_case_avx2 };
+                return { ascii_case_sse2, equal_ignore_case_sse2 };
+#else
+                return { ascii_case_scalar, equal_ignore_case_scalar };
+#endif
+            }();
+            return kernels;
+        }
+    }
+
+    /**
+     * @brief Converts (in-place) std::string to lower case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @param str - std::string that needs to be converted.
+     */
+    inline void to_lower_inplace(std::string & str)
+    {
+        detail::case_kernels_for_cpu().convert(str.data(), str.data() + str.size(), 'A');
+    }
+
+    /**
+     * @brief Converts (in-place) std::string to upper case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @param str - std::string that needs to be converted.
+     */
+    inline void to_upper_inplace(std::string & str)
+    {
+        detail::case_kernels_for_cpu().convert(str.data(), str.data() + str.size(), 'a');
+    }
+
+    /**
+     * @brief Converts std::string to lower case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @param str - std::string that needs to be converted.
+     * @return Lower case input std::string.
+     */
+    inline std::string to_lower(const std::string & str)
+    {
+        auto result = str;
+        to_lower_inplace(result);
+
+        return result;
+    }
+
+    /**
+     * @brief Converts std::string to upper case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @param str - std::string that needs to be converted.
+     * @return Upper case input std::string.
+     */
+    inline std::string to_upper(const std::string & str)
+    {
+        auto result = str;
+        to_upper_inplace(result);
+
+        return result;
+    }
+
+    /**
+     * @brief Converts the first character of a string to uppercase letter and lowercases all other characters, if any.
+     * @param str - input string to be capitalized.
+     * @return A string with the first letter capitalized and all other characters lowercased. It doesn't modify the input string.
+     */
+    inline std::string capitalize(const std::string & str)
+    {
+        auto result = str;
+        if (!result.empty())
+        {
+            result.front() = static_cast<char>(std::toupper(result.front()));
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Converts only the first character of a string to uppercase letter, all other characters stay unchanged.
+     * @param str - input string to be modified.
+     * @return A string with the first letter capitalized. All other characters stay unchanged. It doesn't modify the input string.
+     */
+    inline std::string capitalize_first_char(const std::string & str)
+    {
+        auto result = to_lower(str);
+        if (!result.empty())
+        {
+            result.front() = static_cast<char>(std::toupper(result.front()));
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Checks if input std::string str contains specified substring.
+     * @param str - std::string to be checked.
+     * @param substring - searched substring.
+     * @return True if substring was found in str, false otherwise.
+     */
+    inline bool contains(const std::string & str, const std::string & substring)
+    {
+        return str.find(substring) != std::string::npos;
+    }
+
+    /**
+     * @brief Checks if input std::string str contains specified character.
+     * @param str - std::string to be checked.
+     * @param character - searched character.
+     * @return True if character was found in str, false otherwise.
+     */
+    inline bool contains(const std::string & str, const char character)
+    {
+        return str.find(character) != std::string::npos;
+    }
+
+    /**
+     * @brief Compares two strings ignoring their case (lower/upper).
+     *        Only ASCII letters are folded, independently of the global locale.
+     *        Nothing is allocated; strings of different length are rejected
+     *        without looking at their contents.
+     * @param str1 - string to compare
+     * @param str2 - string to compare
+     * @return True if str1 and str2 are equal, false otherwise.
+     */
+    inline bool compare_ignore_case(std::string_view str1, std::string_view str2)
+    {
+        return str1.size() == str2.size() &&
+               detail::case_kernels_for_cpu().equal(str1.data(), str2.data(), str1.size());
+    }
+
+    namespace detail
+    {
+        // Membership of a char_set: a 256-bit map plus the two 16-byte tables
+        // of the "truffle" nibble lookup. Entry (byte & 0x0F) of low (bytes
+        // below 0x80) or high (the others) has bit ((byte >> 4) & 7) set for
+        // each member, so one shuffle per table classifies a whole vector.
+        struct char_set_tables
+        {
+            uint64_t bits[4] = {};
+            uint8_t  low[16] = {};
+            uint8_t  high[16] = {};
+        };
+
+        inline bool in_set(const char_set_tables & set, unsigned char byte)
+        {
+            return ((set.bits[byte >> 6] >> (byte & 63)) & 1) != 0;
+        }
+
+        inline const char * find_in_set_scalar(const char * first, const char * last, const char_set_tables & set)
+        {
+            for (; first != last && !in_set(set, static_cast<unsigned char>(*first)); ++first)
+            {
+            }
+            return first;
+        }
+
+#if defined(STRUTIL_X86_SIMD)
+        STRUTIL_TARGET("ssse3")
+        inline unsigned set_mask_ssse3(__m128i block, __m128i low, __m128i high)
+        {
+            // Shuffles zero lanes whose index has the top bit set, so each
+            // table only answers for its half of the byte range.
+            const __m128i bit_of     = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            const __m128i candidates = _mm_or_si128(_mm_shuffle_epi8(low, block),
+                                                    _mm_shuffle_epi8(high, _mm_xor_si128(block, _mm_set1_epi8(-128))));
+            const __m128i bits       = _mm_shuffle_epi8(bit_of, _mm_and_si128(_mm_srli_epi16(block, 4), _mm_set1_epi8(0x07)));
+            const __m128i missing    = _mm_cmpeq_epi8(_mm_and_si128(candidates, bits), _mm_setzero_si128());
+            return ~static_cast<unsigned>(_mm_movemask_epi8(missing)) & 0xFFFFu;
+        }
+
+        STRUTIL_TARGET("ssse3")
+        inline const char * find_in_set_ssse3(const char * first, const char * last, const char_set_tables & set)
+        {
+            const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(set.low));
+            const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(set.high));
+            for (; last - first >= 16; first += 16)
+            {
+                const unsigned mask = set_mask_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first)), low, high);
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            return find_in_set_scalar(first, last, set);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline const char * find_in_set_avx2(const char * first, const char * last, const char_set_tables & set)
+        {
+            const __m256i low    = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.low)));
+            const __m256i high   = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(set.high)));
+            const __m256i bit_of = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                                    1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+            for (; last - first >= 32; first += 32)
+            {
+                const __m256i block      = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+                const __m256i candidates = _mm256_or_si256(_mm256_shuffle_epi8(low, block),
+                                                           _mm256_shuffle_epi8(high, _mm256_xor_si256(block, _mm256_set1_epi8(-128))));
+                const __m256i bits       = _mm256_shuffle_epi8(bit_of, _mm256_and_si256(_mm256_srli_epi16(block, 4), _mm256_set1_epi8(0x07)));
+                const __m256i missing    = _mm256_cmpeq_epi8(_mm256_and_si256(candidates, bits), _mm256_setzero_si256());
+                const unsigned mask      = ~static_cast<unsigned>(_mm256_movemask_epi8(missing));
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            return find_in_set_ssse3(first, last, set);
+        }
+#endif // STRUTIL_X86_SIMD
+
+        using find_in_set_kernel = const char * (*)(const char *, const char *, const char_set_tables &);
+
+        inline find_in_set_kernel find_in_set_for_cpu()
+        {
+            static const find_in_set_kernel kernel = []() -> find_in_set_kernel
+            {
+#if defined(STRUTIL_X86_SIMD)
+                if (cpu().avx2)  return find_in_set_avx2;
+                if (cpu().ssse3) return find_in_set_ssse3;
+#endif
+                return find_in_set_scalar;
+            }();
+            return kernel;
+        }
+    }
+
+    /**
+     * @brief Set of characters for split_any, find_first_of and the trim
+     *        overloads that take one. Usable at compile time; membership is a
+     *        256-bit map, and searching runs an SSSE3/AVX2 nibble-lookup kernel
+     *        that tests 16 or 32 bytes at once whatever the size of the set.
+     *
+     *        constexpr strutil::char_set delims(",;\t");
+     */
+    class char_set
+    {
+    public:
+        constexpr char_set() = default;
+
+        /**
+         * @param chars - the characters in the set.
+         */
+        explicit constexpr char_set(std::string_view chars)
+        {
+            for (const char c : chars)
+            {
+                insert(c);
+            }
+        }
+
+        //! The white spaces trim removes: " \t\n\v\f\r".
+        static constexpr char_set space()
+        {
+            return char_set(" \t\n\v\f\r");
+        }
+
+        //! Adds c to the set.
+        constexpr char_set & insert(char c)
+        {
+            const unsigned char byte = static_cast<unsigned char>(c);
+            tables_.bits[byte >> 6] |= uint64_t(1) << (byte & 63);
+            (byte < 0x80 ? tables_.low : tables_.high)[byte & 0x0F] |= static_cast<uint8_t>(1u << ((byte >> 4) & 7));
+            return *this;
+        }
+
+        //! Adds the characters from first to last, both included.
+        constexpr char_set & insert_range(char first, char last)
+        {
+            for (unsigned byte = static_cast<unsigned char>(first); byte <= static_cast<unsigned char>(last); ++byte)
+            {
+                insert(static_cast<char>(byte));
+            }
+            return *this;
+        }
+
+        constexpr bool contains(char c) const
+        {
+            const unsigned char byte = static_cast<unsigned char>(c);
+            return ((tables_.bits[byte >> 6] >> (byte & 63)) & 1) != 0;
+        }
+
+        constexpr bool empty() const
+        {
+            return (tables_.bits[0] | tables_.bits[1] | tables_.bits[2] | tables_.bits[3]) == 0;
+        }
+
+        //! Set of the characters not in this one.
+        constexpr char_set operator~() const
+        {
+            char_set complement;
+            for (unsigned byte = 0; byte < 256; ++byte)
+            {
+                if (!contains(static_cast<char>(byte)))
+                {
+                    complement.insert(static_cast<char>(byte));
+                }
+            }
+            return complement;
+        }
+
+        //! Set of the characters in either set.
+        constexpr char_set operator|(const char_set & other) const
+        {
+            char_set both = *this;
+            for (size_t i = 0; i < 4; ++i) both.tables_.bits[i] |= other.tables_.bits[i];
+            for (size_t i = 0; i < 16; ++i) both.tables_.low[i] |= other.tables_.low[i];
+            for (size_t i = 0; i < 16; ++i) both.tables_.high[i] |= other.tables_.high[i];
+            return both;
+        }
+
+        /**
+         * @brief Finds the first character of [first, last) in the set.
+         * @return Pointer to it, or last if there is none.
+         */
+        const char * find(const char * first, const char * last) const
+        {
+            return detail::find_in_set_for_cpu()(first, last, tables_);
+        }
+
+    private:
+        detail::char_set_tables tables_;
+    };
+
+    /**
+     * @brief Finds the first character of str at or after pos that is in set.
+     * @param str - std::string_view to be searched.
+     * @param set - the characters to look for.
+     * @param pos - offset to start searching at.
+     * @return Offset of the character, or std::string_view::npos if there is none.
+     */
+    inline size_t find_first_of(std::string_view str, const char_set & set, size_t pos = 0)
+    {
+        if (pos >= str.size())
+        {
+            return std::string_view::npos;
+        }
+        const char * last  = str.data() + str.size();
+        const char * found = set.find(str.data() + pos, last);
+        return found == last ? std::string_view::npos : static_cast<size_t>(found - str.data());
+    }
+
+    /**
+     * @brief Trims (in-place) white spaces from the left side of std::string.
+     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
+     * @param str - input std::string to remove white spaces from.
+     */
+    inline void trim_left(std::string & str)
+    {
+        str.erase(str.begin(), std::find_if(str.begin(), str.end(), [](unsigned char ch) { return !std::isspace(ch); }));
+    }
+
+    /**
+     * @brief Trims (in-place) white spaces from the right side of std::string.
+     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
+     * @param str - input std::string to remove white spaces from.
+     */
+    inline void trim_right(std::string & str)
+    {
+        str.erase(std::find_if(str.rbegin(), str.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), str.end());
+    }
+
+    /**
+     * @brief Trims (in-place) white spaces from the both sides of std::string.
+     *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
+     * @param str - input std::string to remove white spaces from.
+     */
+    inline void trim(std::string & str)
+    {
+        trim_left(str);
+        trim_right(str);
+    }
+
+     /**
+      * @brief Trims white spaces from the left side of std::string.
+      *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
+      * @param str - input std::string to remove white spaces from.
+      * @return Copy of input str with trimmed white spaces.
+      */
+    inline std::string trim_left_copy(std::string str)
+    {
+        trim_left(str);
+        return str;
+    }
+
+    /**
+      * @brief Trims white spaces from the right side of std::string.
       *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
       * @param str - input std::string to remove white spaces from.
       * @return Copy of input str with trimmed white spaces.
       */
     inline std::string trim_right_copy(std::string str)
     {
-        trim_right(str);
-        return str;
+        trim_right(str);
+        return str;
+    }
+
+    /**
+      * @brief Trims white spaces from the both sides of std::string.
+      *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
+      * @param str - input std::string to remove white spaces from.
+      * @return Copy of input str with trimmed white spaces.
+      */
+    inline std::string trim_copy(std::string str)
+    {
+        trim(str);
+        return str;
+    }
+
+    /**
+     * @brief Trims white spaces from the left side of std::string_view,
+     *        with the same notion of white space as trim_left.
+     * @param str - input std::string_view to remove white spaces from.
+     * @return View of str without leading white spaces.
+     */
+    inline std::string_view trim_left_view(std::string_view str)
+    {
+        const auto first = std::find_if(str.begin(), str.end(), [](unsigned char ch) { return !std::isspace(ch); });
+        return str.substr(static_cast<size_t>(first - str.begin()));
+    }
+
+    /**
+     * @brief Trims white spaces from the right side of std::string_view,
+     *        with the same notion of white space as trim_right.
+     * @param str - input std::string_view to remove white spaces from.
+     * @return View of str without trailing white spaces.
+     */
+    inline std::string_view trim_right_view(std::string_view str)
+    {
+        const auto last = std::find_if(str.rbegin(), str.rend(), [](unsigned char ch) { return !std::isspace(ch); });
+        return str.substr(0, static_cast<size_t>(str.rend() - last));
+    }
+
+    /**
+     * @brief Trims white spaces from the both sides of std::string_view,
+     *        with the same notion of white space as trim.
+     * @param str - input std::string_view to remove white spaces from.
+     * @return View of str without leading and trailing white spaces.
+     */
+    inline std::string_view trim_view(std::string_view str)
+    {
+        return trim_right_view(trim_left_view(str));
+    }
+
+    /**
+     * @brief Trims the characters in chars from the left side of std::string_view.
+     * @param str - input std::string_view to trim.
+     * @param chars - the characters to remove.
+     * @return View of str without leading characters from chars.
+     */
+    inline std::string_view trim_left_view(std::string_view str, const char_set & chars)
+    {
+        size_t first = 0;
+        while (first < str.size() && chars.contains(str[first]))
+        {
+            ++first;
+        }
+        return str.substr(first);
+    }
+
+    /**
+     * @brief Trims the characters in chars from the right side of std::string_view.
+     * @param str - input std::string_view to trim.
+     * @param chars - the characters to remove.
+     * @return View of str without trailing characters from chars.
+     */
+    inline std::string_view trim_right_view(std::string_view str, const char_set & chars)
+    {
+        size_t last = str.size();
+        while (last > 0 && chars.contains(str[last - 1]))
+        {
+            --last;
+        }
+        return str.substr(0, last);
+    }
+
+    /**
+     * @brief Trims the characters in chars from both sides of std::string_view.
+     * @param str - input std::string_view to trim.
+     * @param chars - the characters to remove.
+     * @return View of str without leading and trailing characters from chars.
+     */
+    inline std::string_view trim_view(std::string_view str, const char_set & chars)
+    {
+        return trim_right_view(trim_left_view(str, chars), chars);
+    }
+
+    /**
+     * @brief Trims (in-place) the characters in chars from the left side of std::string.
+     * @param str - input std::string to trim.
+     * @param chars - the characters to remove.
+     */
+    inline void trim_left(std::string & str, const char_set & chars)
+    {
+        str.erase(0, str.size() - trim_left_view(str, chars).size());
+    }
+
+    /**
+     * @brief Trims (in-place) the characters in chars from the right side of std::string.
+     * @param str - input std::string to trim.
+     * @param chars - the characters to remove.
+     */
+    inline void trim_right(std::string & str, const char_set & chars)
+    {
+        str.resize(trim_right_view(str, chars).size());
+    }
+
+    /**
+     * @brief Trims (in-place) the characters in chars from both sides of std::string.
+     * @param str - input std::string to trim.
+     * @param chars - the characters to remove.
+     */
+    inline void trim(std::string & str, const char_set & chars)
+    {
+        trim_right(str, chars);
+        trim_left(str, chars);
+    }
+
+    /**
+     * @brief Trims the characters in chars from both sides of std::string.
+     * @param str - input std::string to trim.
+     * @param chars - the characters to remove.
+     * @return Copy of input str without leading and trailing characters from chars.
+     */
+    inline std::string trim_copy(std::string str, const char_set & chars)
+    {
+        trim(str, chars);
+        return str;
+    }
+
+    /**
+     * @brief Applies op in-place to every element of a container, e.g.
+     *        transform_all(lines, [](std::string & s) { replace_all(s, "\t", " "); }).
+     *        The whole batch is one call with op inlined into the loop, instead
+     *        of a call per element.
+     * @tparam Container - container type.
+     * @tparam Op - callable taking a reference to an element.
+     * @param tokens - container of elements.
+     * @param op - the operation applied to each element.
+     */
+    template<typename Container, typename Op>
+    inline void transform_all(Container & tokens, Op op)
+    {
+        for (auto & token : tokens)
+        {
+            op(token);
+        }
+    }
+
+    /**
+     * @brief Trims (in-place) white spaces from both sides of every std::string in a container.
+     * @tparam Container - container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void trim_all(Container & strs)
+    {
+        transform_all(strs, [](std::string & str) { trim(str); });
+    }
+
+    /**
+     * @brief Trims (in-place) the characters in chars from both sides of every std::string in a container.
+     * @tparam Container - container type.
+     * @param strs - container of strings.
+     * @param chars - the characters to remove.
+     */
+    template<typename Container>
+    inline void trim_all(Container & strs, const char_set & chars)
+    {
+        transform_all(strs, [&chars](std::string & str) { trim(str, chars); });
+    }
+
+    /**
+     * @brief Converts (in-place) every std::string in a container to lower case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @tparam Container - container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void to_lower_all(Container & strs)
+    {
+        transform_all(strs, [](std::string & str) { to_lower_inplace(str); });
+    }
+
+    /**
+     * @brief Converts (in-place) every std::string in a container to upper case.
+     *        Only ASCII letters are converted, independently of the global locale.
+     * @tparam Container - container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void to_upper_all(Container & strs)
+    {
+        transform_all(strs, [](std::string & str) { to_upper_inplace(str); });
+    }
+
+    /**
+     * @brief Converts every string in a container into datatype T, like parse_string.
+     * @tparam T - the datatype to parse.
+     * @tparam Container - container of std::string, std::string_view or other
+     *                     types convertible to std::string_view.
+     * @param strs - container of strings.
+     * @return std::vector<T> with the parsed values, T{} where parsing failed.
+     */
+    template<typename T, typename Container>
+    inline std::vector<T> parse_all(const Container & strs)
+    {
+        std::vector<T> values;
+        values.reserve(std::size(strs));
+        for (const auto & str : strs)
+        {
+            values.push_back(parse_string<T>(std::string_view(str)));
+        }
+        return values;
+    }
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+    /**
+     * @brief Parallel variant of transform_all. The container is cut into
+     *        blocks of at most parallel_grain() consecutive elements that run
+     *        on the shared thread_pool, so op must be safe to call concurrently
+     *        on different elements. Containers of one block stay serial.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam Container - random access container type.
+     * @tparam Op - callable taking a reference to an element.
+     * @param tokens - container of elements.
+     * @param op - the operation applied to each element.
+     */
+    template<typename Container, typename Op>
+    inline void transform_all_par(Container & tokens, Op op)
+    {
+        const auto first = std::begin(tokens);
+        detail::parallel_pool()->parallel_for(std::size(tokens), parallel_grain(), [&](size_t begin, size_t end)
+        {
+            const auto block_end = first + static_cast<std::ptrdiff_t>(end);
+            for (auto it = first + static_cast<std::ptrdiff_t>(begin); it != block_end; ++it)
+            {
+                op(*it);
+            }
+        });
+    }
+
+    /**
+     * @brief Parallel variant of trim_all.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam Container - random access container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void trim_all_par(Container & strs)
+    {
+        transform_all_par(strs, [](std::string & str) { trim(str); });
+    }
+
+    /**
+     * @brief Parallel variant of trim_all with a set of characters to remove.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam Container - random access container type.
+     * @param strs - container of strings.
+     * @param chars - the characters to remove.
+     */
+    template<typename Container>
+    inline void trim_all_par(Container & strs, const char_set & chars)
+    {
+        transform_all_par(strs, [&chars](std::string & str) { trim(str, chars); });
+    }
+
+    /**
+     * @brief Parallel variant of to_lower_all.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam Container - random access container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void to_lower_all_par(Container & strs)
+    {
+        transform_all_par(strs, [](std::string & str) { to_lower_inplace(str); });
+    }
+
+    /**
+     * @brief Parallel variant of to_upper_all.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam Container - random access container type.
+     * @param strs - container of strings.
+     */
+    template<typename Container>
+    inline void to_upper_all_par(Container & strs)
+    {
+        transform_all_par(strs, [](std::string & str) { to_upper_inplace(str); });
+    }
+
+    /**
+     * @brief Parallel variant of parse_all. T must be default constructible.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @tparam T - the datatype to parse.
+     * @tparam Container - random access container of strings.
+     * @param strs - container of strings.
+     * @return std::vector<T> with the parsed values, T{} where parsing failed.
+     */
+    template<typename T, typename Container>
+    inline std::vector<T> parse_all_par(const Container & strs)
+    {
+        // std::vector<bool> packs elements into shared words, so bools are
+        // parsed into chars and converted once all blocks are done.
+        using stored_type = std::conditional_t<std::is_same_v<T, bool>, char, T>;
+
+        std::vector<stored_type> values(std::size(strs));
+        const auto               first = std::begin(strs);
+        detail::parallel_pool()->parallel_for(values.size(), parallel_grain(), [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                values[i] = parse_string<T>(std::string_view(first[static_cast<std::ptrdiff_t>(i)]));
+            }
+        });
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            return std::vector<bool>(values.begin(), values.end());
+        }
+        else
+        {
+            return values;
+        }
+    }
+#endif // STRUTIL_ENABLE_PARALLEL
+
+    /**
+     * @brief Replaces (in-place) the first occurrence of target with replacement.
+     *        Taken from: http://stackoverflow.com/questions/3418231/c-replace-part-of-a-string-with-another-string.
+     * @param str - input std::string that will be modified.
+     * @param target - substring that will be replaced with replacement.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_first(std::string & str, const std::string & target, const std::string & replacement)
+    {
+        if (target.empty())
+        {
+            return false;
+        }
+        
+        const size_t start_pos = str.find(target);
+        if (start_pos == std::string::npos)
+        {
+            return false;
+        }
+
+        str.replace(start_pos, target.length(), replacement);
+        return true;
+    }
+
+    /**
+     * @brief Replaces (in-place) last occurrence of target with replacement.
+     *        Taken from: http://stackoverflow.com/questions/3418231/c-replace-part-of-a-string-with-another-string.
+     * @param str - input std::string that will be modified.
+     * @param target - substring that will be replaced with replacement.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_last(std::string & str, const std::string & target, const std::string & replacement)
+    {
+        if (target.empty())
+        {
+            return false;
+        }
+
+        size_t start_pos = str.rfind(target);
+        if (start_pos == std::string::npos)
+        {
+            return false;
+        }
+
+        str.replace(start_pos, target.length(), replacement);
+        return true;
+    }
+
+    namespace detail
+    {
+        // replace_all/replace_all_copy bodies, parameterized by how the next
+        // occurrence of a non-empty target of target_size bytes is found:
+        // find(view, pos) behaves like std::string_view::find.
+        template<typename Find>
+        inline std::string replace_all_copy_with(std::string_view str, size_t target_size, std::string_view replacement, const Find & find)
+        {
+            size_t count = 0;
+            for (size_t pos = find(str, 0); pos != std::string_view::npos; pos = find(str, pos + target_size))
+            {
+                ++count;
+            }
+
+            std::string result;
+            result.reserve(str.size() - count * target_size + count * replacement.size());
+
+            size_t last = 0;
+            for (size_t pos = find(str, 0); pos != std::string_view::npos; pos = find(str, last))
+            {
+                result.append(str, last, pos - last);
+                result.append(replacement);
+                last = pos + target_size;
+            }
+            result.append(str, last, std::string_view::npos);
+
+            return result;
+        }
+
+        template<typename Find>
+        inline bool replace_all_with(std::string & str, size_t target_size, std::string_view replacement, bool target_aliases, const Find & find)
+        {
+            size_t pos = find(str, 0);
+            if (pos == std::string::npos)
+            {
+                return false;
+            }
+
+            // Views into str itself would be clobbered by the in-place passes.
+            const bool replacement_aliases = !replacement.empty() &&
+                std::less_equal<const char *>()(str.data(), replacement.data()) &&
+                std::less<const char *>()(replacement.data(), str.data() + str.size());
+
+            if (target_aliases || replacement_aliases || replacement.size() > target_size)
+            {
+                str = replace_all_copy_with(str, target_size, replacement, find);
+            }
+            else if (replacement.size() == target_size)
+            {
+                do
+                {
+                    str.replace(pos, replacement.size(), replacement);
+                    pos = find(str, pos + target_size);
+                } while (pos != std::string::npos);
+            }
+            else
+            {
+                char * const data = &str[0];
+                size_t write = pos;
+                size_t read  = pos;
+                while (pos != std::string::npos)
+                {
+                    std::memmove(data + write, data + read, pos - read);
+                    write += pos - read;
+                    std::memcpy(data + write, replacement.data(), replacement.size());
+                    write += replacement.size();
+                    read = pos + target_size;
+                    pos  = find(str, read);
+                }
+                std::memmove(data + write, data + read, str.size() - read);
+                str.resize(write + str.size() - read);
+            }
+
+            return true;
+        }
+    }
+
+    /**
+     * @brief Returns a copy of str with all (non-overlapping, left to right)
+     *        occurrences of target replaced with replacement. The result is
+     *        sized once and built segment by segment; str is not modified.
+     * @param str - input std::string_view.
+     * @param target - substring that will be replaced with replacement.
+     * @param replacement - substring that will replace target.
+     * @return std::string with the replacements applied; a copy of str if
+     *         target is empty or not found.
+     */
+    inline std::string replace_all_copy(std::string_view str, std::string_view target, std::string_view replacement)
+    {
+        if (target.empty())
+        {
+            return std::string(str);
+        }
+
+        return detail::replace_all_copy_with(str, target.size(), replacement, [target](std::string_view view, size_t pos) {
+            return view.find(target, pos);
+        });
+    }
+
+    /**
+     * @brief Replaces (in-place) all occurrences of target with replacement.
+     *        Runs in linear time: equal-length replacements overwrite the
+     *        matches, shorter ones compact the string in a single pass, and
+     *        longer ones build the result once via replace_all_copy.
+     * @param str - input std::string that will be modified.
+     * @param target - substring that will be replaced with replacement.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_all(std::string & str, std::string_view target, std::string_view replacement)
+    {
+        if (target.empty())
+        {
+            return false;
+        }
+
+        const bool target_aliases = std::less_equal<const char *>()(str.data(), target.data()) &&
+                                    std::less<const char *>()(target.data(), str.data() + str.size());
+
+        return detail::replace_all_with(str, target.size(), replacement, target_aliases, [target](std::string_view view, size_t pos) {
+            return view.find(target, pos);
+        });
+    }
+
+    namespace detail
+    {
+        // Aho-Corasick automaton over a set of byte patterns, compiled into a
+        // full DFA whose columns are byte equivalence classes (bytes that do
+        // not occur in any pattern share one class). Empty patterns never match.
+        class aho_corasick
+        {
+        public:
+            struct match
+            {
+                size_t pattern  = 0;
+                size_t position = 0;
+                size_t length   = 0;
+            };
+
+            aho_corasick() = default;
+
+            explicit aho_corasick(const std::vector<std::string_view> & patterns)
+            {
+                build_classes(patterns);
+
+                // Trie: missing edges are marked with none.
+                add_state(0);
+                for (size_t id = 0; id < patterns.size(); ++id)
+                {
+                    const std::string_view pattern = patterns[id];
+                    if (pattern.empty())
+                    {
+                        continue;
+                    }
+
+                    uint32_t state = 0;
+                    for (const char c : pattern)
+                    {
+                        const size_t edge = state * class_count_ + classes_[static_cast<unsigned char>(c)];
+                        if (transitions_[edge] == none)
+                        {
+                            const uint32_t next = add_state(depth_[state] + 1);
+                            transitions_[edge] = next;
+                        }
+                        state = transitions_[edge];
+                    }
+
+                    max_length_ = std::max(max_length_, pattern.size());
+
+                    // Duplicates keep the first id.
+                    if (match_length_[state] == 0)
+                    {
+                        match_length_[state]  = static_cast<uint32_t>(pattern.size());
+                        match_pattern_[state] = static_cast<uint32_t>(id);
+                    }
+                }
+
+                // Breadth-first: failure links, then missing edges borrowed from
+                // the failure state, which is always shallower and thus complete.
+                std::vector<uint32_t> fail(depth_.size(), 0);
+                std::vector<uint32_t> queue;
+                queue.reserve(depth_.size());
+                for (size_t c = 0; c < class_count_; ++c)
+                {
+                    uint32_t & next = transitions_[c];
+                    if (next == none)
+                    {
+                        next = 0;
+                    }
+                    else
+                    {
+                        queue.push_back(next);
+                    }
+                }
+
+                for (size_t head = 0; head < queue.size(); ++head)
+                {
+                    const uint32_t state = queue[head];
+                    const uint32_t * fallback = &transitions_[fail[state] * class_count_];
+                    if (match_length_[state] == 0)
+                    {
+                        match_length_[state]  = match_length_[fail[state]];
+                        match_pattern_[state] = match_pattern_[fail[state]];
+                    }
+                    output_[state] = ends_pattern(fail[state]) ? fail[state] : output_[fail[state]];
+
+                    uint32_t * row = &transitions_[state * class_count_];
+                    for (size_t c = 0; c < class_count_; ++c)
+                    {
+                        if (row[c] == none)
+                        {
+                            row[c] = fallback[c];
+                        }
+                        else
+                        {
+                            fail[row[c]] = fallback[c];
+                            queue.push_back(row[c]);
+                        }
+                    }
+                }
+            }
+
+            // Leftmost-longest match starting at or after from, the same
+            // non-overlapping choice a left-to-right replace_all makes.
+            bool find(std::string_view text, size_t from, match & result) const
+            {
+                if (depth_.empty())
+                {
+                    return false;
+                }
+
+                bool found = false;
+                uint32_t state = 0;
+                for (size_t i = from; i < text.size(); ++i)
+                {
+                    state = transitions_[state * class_count_ + classes_[static_cast<unsigned char>(text[i])]];
+
+                    // Every match still in progress starts after the current
+                    // candidate: nothing can beat it any more.
+                    if (found && i + 1 - depth_[state] > result.position)
+                    {
+                        break;
+                    }
+
+                    const size_t length = match_length_[state];
+                    if (length != 0)
+                    {
+                        const size_t position = i + 1 - length;
+                        if (!found || position < result.position || (position == result.position && length > result.length))
+                        {
+                            result = { match_pattern_[state], position, length };
+                            found  = true;
+                        }
+                    }
+                }
+
+                return found;
+            }
+
+            // Calls f(pattern, position, length) for the same non-overlapping
+            // matches as repeated find calls, left to right, in one pass over
+            // text. The longest match of each start still open is kept in a
+            // ring buffer with more slots than the longest pattern; a start is
+            // decided once every match in progress starts after it. Time is
+            // linear in the text plus the overlapping occurrences.
+            template<typename F>
+            void for_each_leftmost_longest(std::string_view text, F f) const
+            {
+                if (max_length_ == 0)
+                {
+                    return;
+                }
+
+                size_t window = 1;
+                while (window <= max_length_)
+                {
+                    window *= 2;
+                }
+                struct candidate
+                {
+                    uint32_t length  = 0;
+                    uint32_t pattern = 0;
+                };
+                const size_t           mask = window - 1;
+                std::vector<candidate> longest(window);
+                size_t   open  = 0; // Slots holding a match.
+                size_t   next  = 0; // First start not decided yet.
+                size_t   taken = 0; // End of the last match passed to f.
+                uint32_t state = 0;
+                const auto decide = [&](size_t bound)
+                {
+                    for (; next < bound && open != 0; ++next)
+                    {
+                        candidate & slot = longest[next & mask];
+                        if (slot.length != 0)
+                        {
+                            if (next >= taken)
+                            {
+                                f(static_cast<size_t>(slot.pattern), next, static_cast<size_t>(slot.length));
+                                taken = next + slot.length;
+                            }
+                            slot.length = 0;
+                            --open;
+                        }
+                    }
+                };
+
+                for (size_t i = 0; i < text.size(); ++i)
+                {
+                    state = transitions_[state * class_count_ + classes_[static_cast<unsigned char>(text[i])]];
+                    if (match_length_[state] != 0)
+                    {
+                        if (open == 0)
+                        {
+                            // Starts up to here are decided and hold nothing.
+                            next = std::max(next, i + 1 - depth_[state]);
+                        }
+                        for (uint32_t out = ends_pattern(state) ? state : output_[state]; out != 0; out = output_[out])
+                        {
+                            const size_t position = i + 1 - depth_[out];
+                            candidate &  slot     = longest[position & mask];
+                            if (position >= taken && depth_[out] > slot.length)
+                            {
+                                open += slot.length == 0;
+                                slot  = { depth_[out], match_pattern_[out] };
+                            }
+                        }
+                    }
+                    if (open != 0)
+                    {
+                        decide(i + 1 - depth_[state]);
+                    }
+                }
+                decide(text.size());
+            }
+
+            // True as soon as any pattern ends, without resolving which one.
+            bool matches_anywhere(std::string_view text) const
+            {
+                if (depth_.empty())
+                {
+                    return false;
+                }
+
+                uint32_t state = 0;
+                for (const char c : text)
+                {
+                    state = transitions_[state * class_count_ + classes_[static_cast<unsigned char>(c)]];
+                    if (match_length_[state] != 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            // Calls f(pattern, position) for every occurrence of every pattern,
+            // overlapping ones included, ordered by end position and, for
+            // the same end, from the longest to the shortest pattern.
+            template<typename F>
+            void for_each_overlapping(std::string_view text, F f) const
+            {
+                if (depth_.empty())
+                {
+                    return;
+                }
+
+                uint32_t state = 0;
+                for (size_t i = 0; i < text.size(); ++i)
+                {
+                    state = transitions_[state * class_count_ + classes_[static_cast<unsigned char>(text[i])]];
+                    if (match_length_[state] == 0)
+                    {
+                        continue;
+                    }
+
+                    for (uint32_t out = ends_pattern(state) ? state : output_[state]; out != 0; out = output_[out])
+                    {
+                        f(static_cast<size_t>(match_pattern_[out]), i + 1 - depth_[out]);
+                    }
+                }
+            }
+
+        private:
+            static constexpr uint32_t none = ~uint32_t(0);
+
+            // The state's whole string is a pattern (not just a suffix of it).
+            bool ends_pattern(uint32_t state) const
+            {
+                return state != 0 && match_length_[state] == depth_[state];
+            }
+
+            void build_classes(const std::vector<std::string_view> & patterns)
+            {
+                bool used[256] = {};
+                for (const std::string_view pattern : patterns)
+                {
+                    for (const char c : pattern)
+                    {
+                        used[static_cast<unsigned char>(c)] = true;
+                    }
+                }
+
+                // Class 0 collects every byte absent from the patterns.
+                class_count_ = 1;
+                for (size_t b = 0; b < 256; ++b)
+                {
+                    classes_[b] = used[b] ? static_cast<uint16_t>(class_count_++) : 0;
+                }
+            }
+
+            uint32_t add_state(uint32_t depth)
+            {
+                const uint32_t id = static_cast<uint32_t>(depth_.size());
+                transitions_.resize(transitions_.size() + class_count_, none);
+                depth_.push_back(depth);
+                match_length_.push_back(0);
+                match_pattern_.push_back(0);
+                output_.push_back(0);
+                return id;
+            }
+
+            uint16_t              classes_[256] = {};
+            size_t                class_count_  = 1;
+            size_t                max_length_   = 0;
+            std::vector<uint32_t> transitions_;
+            std::vector<uint32_t> depth_;
+            // Longest pattern that is a suffix of the state's string (0 = none).
+            std::vector<uint32_t> match_length_;
+            std::vector<uint32_t> match_pattern_;
+            // Nearest proper-suffix state whose string is a pattern (0 = none).
+            std::vector<uint32_t> output_;
+        };
+    }
+
+    /**
+     * @brief Set of target/replacement pairs compiled once into an
+     *        Aho-Corasick automaton, for replace_many and replace_many_copy.
+     *        Build it once and reuse it across inputs; it is immutable after
+     *        construction and may be shared between threads.
+     *        Empty targets are ignored; for duplicate targets the first
+     *        replacement wins.
+     */
+    class replacer
+    {
+    public:
+        /**
+         * @brief Compiles the given pairs.
+         * @param pairs - {target, replacement} pairs.
+         */
+        explicit replacer(std::initializer_list<std::pair<std::string_view, std::string_view>> pairs)
+        {
+            init(pairs.begin(), pairs.end());
+        }
+
+        /**
+         * @brief Compiles the pairs of any container of pair-like elements
+         *        (e.g. std::vector<std::pair<std::string, std::string>> or std::map).
+         * @tparam Container - container type.
+         * @param pairs - container of {target, replacement} pairs.
+         */
+        template<typename Container>
+        explicit replacer(const Container & pairs)
+        {
+            init(std::begin(pairs), std::end(pairs));
+        }
+
+        /**
+         * @return Number of target/replacement pairs.
+         */
+        size_t size() const
+        {
+            return targets_.size();
+        }
+
+    private:
+        template<typename Iterator>
+        void init(Iterator first, Iterator last)
+        {
+            for (; first != last; ++first)
+            {
+                targets_.emplace_back(std::string_view(first->first));
+                replacements_.emplace_back(std::string_view(first->second));
+            }
+
+            const std::vector<std::string_view> patterns(targets_.begin(), targets_.end());
+            automaton_ = detail::aho_corasick(patterns);
+        }
+
+        // Appends str with all targets replaced to output and returns the
+        // number of replacements; appends nothing if there are none.
+        size_t apply(std::string_view str, std::string & output) const
+        {
+            size_t count = 0;
+            size_t last  = 0;
+            automaton_.for_each_leftmost_longest(str, [&](size_t pattern, size_t position, size_t length)
+            {
+                if (count++ == 0)
+                {
+                    output.reserve(output.size() + str.size());
+                }
+                output.append(str, last, position - last);
+                output.append(replacements_[pattern]);
+                last = position + length;
+            });
+            if (count != 0)
+            {
+                output.append(str, last, std::string_view::npos);
+            }
+
+            return count;
+        }
+
+        friend std::string replace_many_copy(std::string_view str, const replacer & replacements);
+        friend bool replace_many(std::string & str, const replacer & replacements);
+
+        std::vector<std::string> targets_;
+        std::vector<std::string> replacements_;
+        detail::aho_corasick     automaton_;
+    };
+
+    /**
+     * @brief Returns a copy of str with all targets of replacements replaced
+     *        in a single scan. Among overlapping candidates the leftmost
+     *        match wins, and among those starting at the same position the
+     *        longest; replaced text is never rescanned (like replace_all).
+     *        Time is linear in str plus the number of (overlapping)
+     *        occurrences of the targets.
+     * @param str - input std::string_view.
+     * @param replacements - compiled target/replacement pairs.
+     * @return std::string with the replacements applied.
+     */
+    inline std::string replace_many_copy(std::string_view str, const replacer & replacements)
+    {
+        std::string result;
+        if (replacements.apply(str, result) == 0)
+        {
+            result.assign(str);
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Replaces (in-place) all targets of replacements in a single
+     *        scan, with the same match selection as replace_many_copy.
+     * @param str - input std::string that will be modified.
+     * @param replacements - compiled target/replacement pairs.
+     * @return True if anything was replaced, false otherwise.
+     */
+    inline bool replace_many(std::string & str, const replacer & replacements)
+    {
+        std::string result;
+        if (replacements.apply(str, result) == 0)
+        {
+            return false;
+        }
+
+        str.swap(result);
+        return true;
+    }
+
+    /**
+     * @brief Replaces (in-place) all targets in a single scan; convenience
+     *        overload that compiles a temporary replacer. Prefer a reused
+     *        replacer when the same pairs are applied to many inputs.
+     *
+     *        strutil::replace_many(str, {{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}});
+     * @param str - input std::string that will be modified.
+     * @param pairs - {target, replacement} pairs.
+     * @return True if anything was replaced, false otherwise.
+     */
+    inline bool replace_many(std::string & str, std::initializer_list<std::pair<std::string_view, std::string_view>> pairs)
+    {
+        return replace_many(str, replacer(pairs));
+    }
+
+    /**
+     * @brief Set of needles compiled once into an Aho-Corasick automaton,
+     *        for contains_any, find_first_of_any and find_all_matches.
+     *        Every lookup scans str once, no matter how many needles there
+     *        are. Needles are identified by their index in the input order.
+     *        It is immutable after construction and may be shared between
+     *        threads. Empty needles never match; for duplicate needles the
+     *        first index is reported.
+     */
+    class multi_matcher
+    {
+    public:
+        /**
+         * @brief Compiles the given needles.
+         * @param needles - searched substrings.
+         */
+        explicit multi_matcher(std::initializer_list<std::string_view> needles)
+            : automaton_(std::vector<std::string_view>(needles)), size_(needles.size())
+        {
+        }
+
+        /**
+         * @brief Compiles the needles of any container of string-like elements.
+         * @tparam Container - container type.
+         * @param needles - container of searched substrings.
+         */
+        template<typename Container>
+        explicit multi_matcher(const Container & needles)
+        {
+            std::vector<std::string_view> views;
+            for (const auto & needle : needles)
+            {
+                views.emplace_back(needle);
+            }
+
+            automaton_ = detail::aho_corasick(views);
+            size_      = views.size();
+        }
+
+        /**
+         * @return Number of needles.
+         */
+        size_t size() const
+        {
+            return size_;
+        }
+
+    private:
+        friend bool contains_any(std::string_view str, const multi_matcher & needles);
+        friend std::optional<std::pair<size_t, size_t>> find_first_of_any(std::string_view str, const multi_matcher & needles);
+        friend std::vector<std::pair<size_t, size_t>> find_all_matches(std::string_view str, const multi_matcher & needles);
+
+        detail::aho_corasick automaton_;
+        size_t               size_ = 0;
+    };
+
+    /**
+     * @brief Checks if str contains any of the needles.
+     * @param str - std::string_view to be checked.
+     * @param needles - compiled needles.
+     * @return True if at least one needle was found in str, false otherwise.
+     */
+    inline bool contains_any(std::string_view str, const multi_matcher & needles)
+    {
+        return needles.automaton_.matches_anywhere(str);
+    }
+
+    /**
+     * @brief Finds the first needle occurrence in str: the one with the
+     *        smallest offset, and the longest needle among those starting there.
+     * @param str - std::string_view to be searched.
+     * @param needles - compiled needles.
+     * @return (needle index, offset) pair, or std::nullopt if no needle occurs in str.
+     */
+    inline std::optional<std::pair<size_t, size_t>> find_first_of_any(std::string_view str, const multi_matcher & needles)
+    {
+        detail::aho_corasick::match found;
+        if (!needles.automaton_.find(str, 0, found))
+        {
+            return std::nullopt;
+        }
+        return std::make_pair(found.pattern, found.position);
+    }
+
+    /**
+     * @brief Finds all occurrences of all needles in str, overlapping ones
+     *        included, in a single pass.
+     * @param str - std::string_view to be searched.
+     * @param needles - compiled needles.
+     * @return (needle index, offset) pairs ordered by the position where
+     *         each occurrence ends; for the same end, longer needles first.
+     */
+    inline std::vector<std::pair<size_t, size_t>> find_all_matches(std::string_view str, const multi_matcher & needles)
+    {
+        std::vector<std::pair<size_t, size_t>> result;
+        needles.automaton_.for_each_overlapping(str, [&result](size_t pattern, size_t offset) {
+            result.emplace_back(pattern, offset);
+        });
+        return result;
+    }
+
+    /**
+     * @brief Checks if std::string str ends with specified suffix.
+     * @param str - input std::string that will be checked.
+     * @param suffix - searched suffix in str.
+     * @return True if suffix was found, false otherwise.
+     */
+    inline bool ends_with(const std::string & str, const std::string & suffix)
+    {
+        return suffix.size() <= str.size() &&
+               str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    /**
+     * @brief Checks if std::string str ends with specified character.
+     * @param str - input std::string that will be checked.
+     * @param suffix - searched character in str.
+     * @return True if ends with character, false otherwise.
+     */
+    inline bool ends_with(const std::string & str, const char suffix)
+    {
+        return !str.empty() && (str.back() == suffix);
+    }
+
+    /**
+     * @brief Checks if std::string str starts with specified prefix.
+     * @param str - input std::string that will be checked.
+     * @param prefix - searched prefix in str.
+     * @return True if prefix was found, false otherwise.
+     */
+    inline bool starts_with(const std::string & str, const std::string & prefix)
+    {
+        return str.rfind(prefix, 0) == 0;
+    }
+
+    /**
+     * @brief Checks if std::string str starts with specified character.
+     * @param str - input std::string that will be checked.
+     * @param prefix - searched character in str.
+     * @return True if starts with character, false otherwise.
+     */
+    inline bool starts_with(const std::string & str, const char prefix)
+    {
+        return !str.empty() && (str.front() == prefix);
+    }
+
+    namespace detail
+    {
+        // Single-character scanning kernels behind split, split_view and the
+        // other single-delimiter functions. Every variant returns exactly what
+        // the scalar one does; the vector ones only process 16/32/64 bytes per
+        // step and hand the tail over to a narrower kernel.
+
+        inline const char * find_char_scalar(const char * first, const char * last, char c)
+        {
+            const void * found = std::memchr(first, c, static_cast<size_t>(last - first));
+            return found ? static_cast<const char *>(found) : last;
+        }
+
+        inline size_t count_char_scalar(const char * first, const char * last, char c)
+        {
+            return static_cast<size_t>(std::count(first, last, c));
+        }
+
+#if defined(STRUTIL_X86_SIMD)
+        inline const char * find_char_sse2(const char * first, const char * last, char c)
+        {
+            const __m128i needle = _mm_set1_epi8(c);
+            // Test four blocks per iteration and only locate the hit once found.
+            for (; last - first >= 64; first += 64)
+            {
+                const __m128i m0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first)),      needle);
+                const __m128i m1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + 16)), needle);
+                const __m128i m2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + 32)), needle);
+                const __m128i m3 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + 48)), needle);
+                if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))) != 0)
+                {
+                    const uint64_t mask = static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(m0)))
+                                        | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(m1))) << 16
+                                        | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(m2))) << 32
+                                        | static_cast<uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(m3))) << 48;
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            for (; last - first >= 16; first += 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            return find_char_scalar(first, last, c);
+        }
+
+        inline size_t count_char_sse2(const char * first, const char * last, char c)
+        {
+            const __m128i needle = _mm_set1_epi8(c);
+            size_t count = 0;
+            while (last - first >= 16)
+            {
+                // Matching lanes are -1, so subtracting them counts per byte;
+                // fold into 64-bit lanes before any byte counter can overflow.
+                __m128i counters = _mm_setzero_si128();
+                for (int i = 0; i < 255 && last - first >= 16; ++i, first += 16)
+                {
+                    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                    counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(block, needle));
+                }
+                const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+                count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+            }
+            return count + count_char_scalar(first, last, c);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline const char * find_char_avx2(const char * first, const char * last, char c)
+        {
+            const __m256i needle = _mm256_set1_epi8(c);
+            for (; last - first >= 128; first += 128)
+            {
+                const __m256i m0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first)),      needle);
+                const __m256i m1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + 32)), needle);
+                const __m256i m2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + 64)), needle);
+                const __m256i m3 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + 96)), needle);
+                if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(m0, m1), _mm256_or_si256(m2, m3)), _mm256_set1_epi8(-1)))
+                {
+                    const uint64_t low  = static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(m0)))
+                                        | static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(m1))) << 32;
+                    if (low != 0)
+                    {
+                        return first + count_trailing_zeros(low);
+                    }
+                    const uint64_t high = static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(m2)))
+                                        | static_cast<uint64_t>(static_cast<unsigned>(_mm256_movemask_epi8(m3))) << 32;
+                    return first + 64 + count_trailing_zeros(high);
+                }
+            }
+            for (; last - first >= 32; first += 32)
+            {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+                const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            return find_char_sse2(first, last, c);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline size_t count_char_avx2(const char * first, const char * last, char c)
+        {
+            const __m256i needle = _mm256_set1_epi8(c);
+            size_t count = 0;
+            while (last - first >= 32)
+            {
+                __m256i counters = _mm256_setzero_si256();
+                for (int i = 0; i < 255 && last - first >= 32; ++i, first += 32)
+                {
+                    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+                    counters = _mm256_sub_epi8(counters, _mm256_cmpeq_epi8(block, needle));
+                }
+                uint64_t sums[4];
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums), _mm256_sad_epu8(counters, _mm256_setzero_si256()));
+                count += static_cast<size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+            }
+            return count + count_char_sse2(first, last, c);
+        }
+
+        STRUTIL_TARGET("avx512f,avx512bw")
+        inline const char * find_char_avx512(const char * first, const char * last, char c)
+        {
+            const __m512i needle = _mm512_set1_epi8(c);
+            for (; last - first >= 256; first += 256)
+            {
+                const uint64_t m0 = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(reinterpret_cast<const void *>(first)),       needle);
+                const uint64_t m1 = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(reinterpret_cast<const void *>(first + 64)),  needle);
+                const uint64_t m2 = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(reinterpret_cast<const void *>(first + 128)), needle);
+                const uint64_t m3 = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(reinterpret_cast<const void *>(first + 192)), needle);
+                if ((m0 | m1 | m2 | m3) != 0)
+                {
+                    if (m0 != 0) return first + count_trailing_zeros(m0);
+                    if (m1 != 0) return first + 64 + count_trailing_zeros(m1);
+                    if (m2 != 0) return first + 128 + count_trailing_zeros(m2);
+                    return first + 192 + count_trailing_zeros(m3);
+                }
+            }
+            for (; last - first >= 64; first += 64)
+            {
+                const __m512i block = _mm512_loadu_si512(reinterpret_cast<const void *>(first));
+                const uint64_t mask = _mm512_cmpeq_epi8_mask(block, needle);
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+            }
+            return find_char_avx2(first, last, c);
+        }
+
+        STRUTIL_TARGET("avx512f,avx512bw")
+        inline size_t count_char_avx512(const char * first, const char * last, char c)
+        {
+            const __m512i needle = _mm512_set1_epi8(c);
+            size_t count = 0;
+            for (; last - first >= 64; first += 64)
+            {
+                const __m512i block = _mm512_loadu_si512(reinterpret_cast<const void *>(first));
+                count += popcount(_mm512_cmpeq_epi8_mask(block, needle));
+            }
+            return count + count_char_avx2(first, last, c);
+        }
+#endif // STRUTIL_X86_SIMD
+
+        struct char_kernels
+        {
+            const char * (*find)(const char *, const char *, char);
+            size_t       (*count)(const char *, const char *, char);
+        };
+
+        // The widest kernels the running CPU supports, chosen on first use.
+        inline const char_kernels & char_kernels_for_cpu()
+        {
+            static const char_kernels kernels = []() -> char_kernels
+            {
+#if defined(STRUTIL_X86_SIMD)
+                if (cpu().avx512bw) return { find_char_avx512, count_char_avx512 };
+                if (cpu().avx2)     return { find_char_avx2,   count_char_avx2 };
+                return { find_char_sse2, count_char_sse2 };
+#else
+                return { find_char_scalar, count_char_scalar };
+#endif
+            }();
+            return kernels;
+        }
+
+        /**
+         * @brief Finds the first occurrence of c in [first, last).
+         * @return Pointer to the first c, or last if there is none.
+         */
+        inline const char * find_char(const char * first, const char * last, char c)
+        {
+#if defined(STRUTIL_X86_SIMD)
+            // Short fields are the common case: probe the first block inline
+            // before paying for the indirect call into the wide kernel.
+            if (last - first >= 16)
+            {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+                if (mask != 0)
+                {
+                    return first + count_trailing_zeros(mask);
+                }
+                first += 16;
+            }
+#endif
+            return char_kernels_for_cpu().find(first, last, c);
+        }
+
+        /**
+         * @brief Counts the occurrences of c in [first, last).
+         */
+        inline size_t count_char(const char * first, const char * last, char c)
+        {
+            return char_kernels_for_cpu().count(first, last, c);
+        }
+
+        // std::string_view::find(char) counterpart backed by find_char.
+        inline size_t find_char(std::string_view str, char c, size_t pos)
+        {
+            if (pos >= str.size())
+            {
+                return std::string_view::npos;
+            }
+
+            const char * last  = str.data() + str.size();
+            const char * found = find_char(str.data() + pos, last, c);
+            return found == last ? std::string_view::npos : static_cast<size_t>(found - str.data());
+        }
+    }
+
+    namespace detail
+    {
+        // Substring kernels behind searcher for needles of 2 or more bytes.
+        // The vector ones compare a block of candidate windows against the
+        // needle's first and last byte at once and only verify the survivors.
+
+        inline const char * find_substring_scalar(const char * first, const char * last, const char * needle, size_t size)
+        {
+            const std::string_view haystack(first, static_cast<size_t>(last - first));
+            const size_t found = haystack.find(std::string_view(needle, size));
+            return found == std::string_view::npos ? last : first + found;
+        }
+
+#if defined(STRUTIL_X86_SIMD)
+        inline const char * find_substring_sse2(const char * first, const char * last, const char * needle, size_t size)
+        {
+            const __m128i head = _mm_set1_epi8(needle[0]);
+            const __m128i tail = _mm_set1_epi8(needle[size - 1]);
+            for (; static_cast<size_t>(last - first) >= size - 1 + 16; first += 16)
+            {
+                const __m128i heads = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first)), head);
+                const __m128i tails = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(first + size - 1)), tail);
+                for (unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(heads, tails))); mask != 0; mask &= mask - 1)
+                {
+                    const char * candidate = first + count_trailing_zeros(mask);
+                    if (std::memcmp(candidate + 1, needle + 1, size - 2) == 0)
+                    {
+                        return candidate;
+                    }
+                }
+            }
+            return find_substring_scalar(first, last, needle, size);
+        }
+
+        STRUTIL_TARGET("avx2")
+        inline const char * find_substring_avx2(const char * first, const char * last, const char * needle, size_t size)
+        {
+            const __m256i head = _mm256_set1_epi8(needle[0]);
+            const __m256i tail = _mm256_set1_epi8(needle[size - 1]);
+            for (; static_cast<size_t>(last - first) >= size - 1 + 32; first += 32)
+            {
+                const __m256i heads = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first)), head);
+                const __m256i tails = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(first + size - 1)), tail);
+                for (unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(heads, tails))); mask != 0; mask &= mask - 1)
+                {
+                    const char * candidate = first + count_trailing_zeros(mask);
+                    if (std::memcmp(candidate + 1, needle + 1, size - 2) == 0)
+                    {
+                        return candidate;
+                    }
+                }
+            }
+            return find_substring_sse2(first, last, needle, size);
+        }
+#endif // STRUTIL_X86_SIMD
+
+        using find_substring_kernel = const char * (*)(const char *, const char *, const char *, size_t);
+
+        inline find_substring_kernel find_substring_for_cpu()
+        {
+            static const find_substring_kernel kernel = []() -> find_substring_kernel
+            {
+#if defined(STRUTIL_X86_SIMD)
+                return cpu().avx2 ? find_substring_avx2 : find_substring_sse2;
+#else
+                return find_substring_scalar;
+#endif
+            }();
+            return kernel;
+        }
+    }
+
+    /**
+     * @brief A needle preprocessed once for repeated searches, accepted by
+     *        contains, replace_first, replace_last, replace_all,
+     *        replace_all_copy and split in place of a target string.
+     *        Forward searches use a SIMD filter on the needle's first and last
+     *        byte where available; otherwise, and for backward searches, long
+     *        needles use Boyer-Moore-Horspool, which skips up to the needle
+     *        length per step. The searcher owns a copy of the needle and may
+     *        be shared between threads.
+     */
+    class searcher
+    {
+    public:
+        //! Needles at least this long get Boyer-Moore-Horspool skip tables.
+        static constexpr size_t horspool_threshold = 16;
+
+        /**
+         * @brief Preprocesses needle.
+         * @param needle - the searched substring.
+         */
+        explicit searcher(std::string_view needle) : needle_(needle)
+        {
+            const size_t size = needle_.size();
+            if (size < horspool_threshold)
+            {
+                return;
+            }
+
+            // Forward: distance from a byte's last occurrence (excluding the
+            // final position) to the end. Backward: distance from the
+            // start to a byte's first occurrence (excluding position 0).
+            std::fill(std::begin(skip_), std::end(skip_), size);
+            std::fill(std::begin(reverse_skip_), std::end(reverse_skip_), size);
+            for (size_t i = 0; i + 1 < size; ++i)
+            {
+                skip_[static_cast<unsigned char>(needle_[i])] = size - 1 - i;
+            }
+            for (size_t i = size - 1; i > 0; --i)
+            {
+                reverse_skip_[static_cast<unsigned char>(needle_[i])] = i;
+            }
+        }
+
+        /**
+         * @return The needle.
+         */
+        std::string_view needle() const
+        {
+            return needle_;
+        }
+
+        /**
+         * @brief Finds the first occurrence of the needle in str at or after pos,
+         *        like std::string_view::find.
+         * @param str - std::string_view to be searched.
+         * @param pos - position to start at.
+         * @return Offset of the occurrence, or std::string_view::npos.
+         */
+        size_t find(std::string_view str, size_t pos = 0) const
+        {
+            const size_t size = needle_.size();
+            if (pos > str.size() || str.size() - pos < size)
+            {
+                return std::string_view::npos;
+            }
+            if (size == 0)
+            {
+                return pos;
+            }
+            if (size == 1)
+            {
+                return detail::find_char(str, needle_[0], pos);
+            }
+
+            const char * const data = str.data();
+#if !defined(STRUTIL_X86_SIMD)
+            if (size >= horspool_threshold)
+            {
+                const char * const needle = needle_.data();
+                const char tail = needle[size - 1];
+                for (size_t end = pos + size - 1; end < str.size(); end += skip_[static_cast<unsigned char>(data[end])])
+                {
+                    if (data[end] == tail && std::memcmp(data + end - (size - 1), needle, size - 1) == 0)
+                    {
+                        return end - (size - 1);
+                    }
+                }
+                return std::string_view::npos;
+            }
+#endif
+
+            const char * const last  = data + str.size();
+            const char * const found = detail::find_substring_for_cpu()(data + pos, last, needle_.data(), size);
+            return found == last ? std::string_view::npos : static_cast<size_t>(found - data);
+        }
+
+        /**
+         * @brief Finds the last occurrence of the needle in str starting at or
+         *        before pos, like std::string_view::rfind.
+         * @param str - std::string_view to be searched.
+         * @param pos - last position an occurrence may start at.
+         * @return Offset of the occurrence, or std::string_view::npos.
+         */
+        size_t rfind(std::string_view str, size_t pos = std::string_view::npos) const
+        {
+            const size_t size = needle_.size();
+            if (str.size() < size)
+            {
+                return std::string_view::npos;
+            }
+            if (size < horspool_threshold)
+            {
+                return str.rfind(needle_, pos);
+            }
+
+            const char * const data   = str.data();
+            const char * const needle = needle_.data();
+            const char head = needle[0];
+            for (size_t start = std::min(pos, str.size() - size);; )
+            {
+                if (data[start] == head && std::memcmp(data + start + 1, needle + 1, size - 1) == 0)
+                {
+                    return start;
+                }
+
+                const size_t skip = reverse_skip_[static_cast<unsigned char>(data[start])];
+                if (skip > start)
+                {
+                    return std::string_view::npos;
+                }
+                start -= skip;
+            }
+        }
+
+    private:
+        std::string needle_;
+        size_t      skip_[256]         = {};
+        size_t      reverse_skip_[256] = {};
+    };
+
+    /**
+     * @brief Checks if str contains the needle of a searcher.
+     * @param str - std::string_view to be checked.
+     * @param needle - preprocessed searched substring.
+     * @return True if the needle was found in str, false otherwise.
+     */
+    inline bool contains(std::string_view str, const searcher & needle)
+    {
+        return needle.find(str) != std::string_view::npos;
+    }
+
+    /**
+     * @brief Replaces (in-place) the first occurrence of a searcher's needle
+     *        with replacement.
+     * @param str - input std::string that will be modified.
+     * @param target - preprocessed substring that will be replaced.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_first(std::string & str, const searcher & target, std::string_view replacement)
+    {
+        if (target.needle().empty())
+        {
+            return false;
+        }
+
+        const size_t start_pos = target.find(str);
+        if (start_pos == std::string::npos)
+        {
+            return false;
+        }
+
+        str.replace(start_pos, target.needle().size(), replacement);
+        return true;
+    }
+
+    /**
+     * @brief Replaces (in-place) the last occurrence of a searcher's needle
+     *        with replacement.
+     * @param str - input std::string that will be modified.
+     * @param target - preprocessed substring that will be replaced.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_last(std::string & str, const searcher & target, std::string_view replacement)
+    {
+        if (target.needle().empty())
+        {
+            return false;
+        }
+
+        const size_t start_pos = target.rfind(str);
+        if (start_pos == std::string::npos)
+        {
+            return false;
+        }
+
+        str.replace(start_pos, target.needle().size(), replacement);
+        return true;
+    }
+
+    /**
+     * @brief Returns a copy of str with all occurrences of a searcher's
+     *        needle replaced with replacement, like replace_all_copy.
+     * @param str - input std::string_view.
+     * @param target - preprocessed substring that will be replaced.
+     * @param replacement - substring that will replace target.
+     * @return std::string with the replacements applied.
+     */
+    inline std::string replace_all_copy(std::string_view str, const searcher & target, std::string_view replacement)
+    {
+        if (target.needle().empty())
+        {
+            return std::string(str);
+        }
+
+        return detail::replace_all_copy_with(str, target.needle().size(), replacement, [&target](std::string_view view, size_t pos) {
+            return target.find(view, pos);
+        });
+    }
+
+    /**
+     * @brief Replaces (in-place) all occurrences of a searcher's needle with
+     *        replacement, like replace_all.
+     * @param str - input std::string that will be modified.
+     * @param target - preprocessed substring that will be replaced.
+     * @param replacement - substring that will replace target.
+     * @return True if replacement was successfull, false otherwise.
+     */
+    inline bool replace_all(std::string & str, const searcher & target, std::string_view replacement)
+    {
+        if (target.needle().empty())
+        {
+            return false;
+        }
+
+        return detail::replace_all_with(str, target.needle().size(), replacement, false, [&target](std::string_view view, size_t pos) {
+            return target.find(view, pos);
+        });
+    }
+
+    /**
+     * @brief Splits input std::string_view str according to input delim without
+     *        copying the tokens. The returned views point into the memory viewed
+     *        by str, so that memory must outlive the result.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string_view> that contains all split tokens.
+     */
+    inline std::vector<std::string_view> split(std::string_view str, const char delim, bool keep_empty = true)
+    {
+        std::vector<std::string_view> tokens;
+        // Count delimiters up front so the result is allocated exactly once.
+        tokens.reserve(detail::count_char(str.data(), str.data() + str.size(), delim) + 1);
+
+        size_t pos_start = 0, pos_end;
+        while ((pos_end = detail::find_char(str, delim, pos_start)) != std::string_view::npos)
+        {
+            if (keep_empty || pos_end != pos_start)
+            {
+                tokens.push_back(str.substr(pos_start, pos_end - pos_start));
+            }
+            pos_start = pos_end + 1;
+        }
+
+        if (keep_empty || pos_start != str.size())
+        {
+            tokens.push_back(str.substr(pos_start));
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Splits input std::string_view str according to input std::string_view delim
+     *        without copying the tokens. The returned views point into the memory
+     *        viewed by str, so that memory must outlive the result.
+     *        An empty delim never matches, so the whole str is returned as one token.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string_view> that contains all split tokens.
+     */
+    inline std::vector<std::string_view> split(std::string_view str, std::string_view delim, bool keep_empty = true)
+    {
+        std::vector<std::string_view> tokens;
+
+        size_t pos_start = 0, pos_end;
+        if (!delim.empty())
+        {
+            while ((pos_end = str.find(delim, pos_start)) != std::string_view::npos)
+            {
+                if (keep_empty || pos_end != pos_start)
+                {
+                    tokens.push_back(str.substr(pos_start, pos_end - pos_start));
+                }
+                pos_start = pos_end + delim.length();
+            }
+        }
+
+        if (keep_empty || pos_start != str.size())
+        {
+            tokens.push_back(str.substr(pos_start));
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Splits input std::string_view str on the needle of a searcher
+     *        without copying the tokens, like split(str, delim, keep_empty).
+     * @param str - std::string_view that will be split.
+     * @param delim - preprocessed delimiter; an empty needle never matches.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string_view> with the tokens.
+     */
+    inline std::vector<std::string_view> split(std::string_view str, const searcher & delim, bool keep_empty = true)
+    {
+        std::vector<std::string_view> tokens;
+
+        const size_t delim_size = delim.needle().size();
+        size_t pos_start = 0, pos_end;
+        if (delim_size != 0)
+        {
+            while ((pos_end = delim.find(str, pos_start)) != std::string_view::npos)
+            {
+                if (keep_empty || pos_end != pos_start)
+                {
+                    tokens.push_back(str.substr(pos_start, pos_end - pos_start));
+                }
+                pos_start = pos_end + delim_size;
+            }
+        }
+
+        if (keep_empty || pos_start != str.size())
+        {
+            tokens.push_back(str.substr(pos_start));
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Splits input std::string str according to input delim.
+     * @param str - std::string that will be splitted.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split(const std::string & str, const char delim, bool keep_empty = true)
+    {
+        const auto views = split(std::string_view(str), delim, keep_empty);
+        return std::vector<std::string>(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Splits input C string str according to input delim.
+     *        Disambiguates string literals between the std::string and
+     *        std::string_view overloads; tokens are returned as owned strings.
+     * @param str - C string that will be splitted.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split(const char * str, const char delim, bool keep_empty = true)
+    {
+        return split(std::string(str), delim, keep_empty);
+    }
+
+    /**
+     * @brief Splits input std::string str according to input std::string delim.
+     *        Taken from: https://stackoverflow.com/a/46931770/1892346.
+     * @param str - std::string that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split(const std::string & str, const std::string & delim, bool keep_empty = true)
+    {
+        const auto views = split(std::string_view(str), std::string_view(delim), keep_empty);
+        return std::vector<std::string>(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Splits input C string str according to input std::string delim.
+     *        Disambiguates string literals between the std::string and
+     *        std::string_view overloads; tokens are returned as owned strings.
+     * @param str - C string that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split(const char * str, const std::string & delim, bool keep_empty = true)
+    {
+        return split(std::string(str), delim, keep_empty);
+    }
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+    namespace detail
+    {
+        // Smallest share of the input worth a thread of its own in split_par.
+        constexpr size_t split_par_grain = size_t(1) << 20;
+
+        // Splits str in parts chunks that each begin at a token: every even
+        // share boundary is moved forward past the next delim, so no token
+        // straddles two chunks. A first parallel pass sizes each chunk's
+        // output (just counting delimiters when empty tokens are kept), a
+        // second writes the tokens straight to their final positions.
+        template<typename Token>
+        inline std::vector<Token> split_chunked(thread_pool & pool, std::string_view str, char delim, bool keep_empty, size_t parts)
+        {
+            std::vector<size_t> starts = { 0 };
+            for (size_t k = 1; k < parts; ++k)
+            {
+                const size_t found = find_char(str, delim, std::max(starts.back(), str.size() / parts * k));
+                if (found == std::string_view::npos)
+                {
+                    break;
+                }
+                starts.push_back(found + 1);
+            }
+            const auto chunk = [&](size_t i)
+            {
+                // Chunks end just before the delimiter that starts the next one.
+                const size_t last = i + 1 < starts.size() ? starts[i + 1] - 1 : str.size();
+                return str.substr(starts[i], last - starts[i]);
+            };
+
+            // Runs step(i) for every chunk, one chunk per task.
+            const auto for_each_chunk = [&](const auto & step)
+            {
+                pool.parallel_for(starts.size(), 1, [&](size_t first, size_t last)
+                {
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        step(i);
+                    }
+                });
+            };
+
+            std::vector<size_t>                        offsets(starts.size() + 1, 0);
+            std::vector<std::vector<std::string_view>> pieces(keep_empty ? 0 : starts.size());
+            for_each_chunk([&](size_t i)
+            {
+                const std::string_view part = chunk(i);
+                if (keep_empty)
+                {
+                    offsets[i + 1] = count_char(part.data(), part.data() + part.size(), delim) + 1;
+                }
+                else
+                {
+                    pieces[i]      = split(part, delim, false);
+                    offsets[i + 1] = pieces[i].size();
+                }
+            });
+            for (size_t i = 0; i < starts.size(); ++i)
+            {
+                offsets[i + 1] += offsets[i];
+            }
+
+            std::vector<Token> tokens(offsets.back());
+            for_each_chunk([&](size_t i)
+            {
+                auto out = tokens.begin() + static_cast<std::ptrdiff_t>(offsets[i]);
+                if (keep_empty)
+                {
+                    const std::string_view part = chunk(i);
+                    size_t pos_start = 0, pos_end;
+                    while ((pos_end = find_char(part, delim, pos_start)) != std::string_view::npos)
+                    {
+                        *out++    = Token(part.substr(pos_start, pos_end - pos_start));
+                        pos_start = pos_end + 1;
+                    }
+                    *out = Token(part.substr(pos_start));
+                }
+                else
+                {
+                    std::copy(pieces[i].begin(), pieces[i].end(), out);
+                }
+            });
+            return tokens;
+        }
+
+        template<typename Token>
+        inline std::vector<Token> split_par(std::string_view str, char delim, bool keep_empty)
+        {
+            const std::shared_ptr<thread_pool> pool = parallel_pool();
+            const size_t parts = std::clamp<size_t>(str.size() / split_par_grain, 1, pool->concurrency());
+            if (parts == 1)
+            {
+                std::vector<std::string_view> tokens = split(str, delim, keep_empty);
+                if constexpr (std::is_same_v<Token, std::string_view>)
+                {
+                    return tokens;
+                }
+                else
+                {
+                    return std::vector<Token>(tokens.begin(), tokens.end());
+                }
+            }
+            return split_chunked<Token>(*pool, str, delim, keep_empty, parts);
+        }
+    }
+
+    /**
+     * @brief Parallel variant of split(std::string_view, char, bool). The input
+     *        is cut into one chunk per parallel_threads() at delimiter positions,
+     *        chunks are split concurrently and the tokens are returned in their
+     *        original order, identical to split. Inputs under about 1 MiB per
+     *        thread use fewer chunks, down to a plain serial split.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string_view> that contains all split tokens.
+     */
+    inline std::vector<std::string_view> split_par(std::string_view str, const char delim, bool keep_empty = true)
+    {
+        return detail::split_par<std::string_view>(str, delim, keep_empty);
+    }
+
+    /**
+     * @brief Parallel variant of split(const std::string &, char, bool); the
+     *        owned tokens are also copied out concurrently.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param str - std::string that will be splitted.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split_par(const std::string & str, const char delim, bool keep_empty = true)
+    {
+        return detail::split_par<std::string>(str, delim, keep_empty);
+    }
+
+    /**
+     * @brief Parallel variant of split(const char *, char, bool).
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param str - C string that will be splitted.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string> that contains all splitted tokens.
+     */
+    inline std::vector<std::string> split_par(const char * str, const char delim, bool keep_empty = true)
+    {
+        return detail::split_par<std::string>(str, delim, keep_empty);
+    }
+#endif // STRUTIL_ENABLE_PARALLEL
+
+    /**
+     * @brief Thread-safe LRU cache of compiled std::regex objects keyed by
+     *        pattern and syntax flags, for the regex_split/regex_split_map
+     *        overloads that take one. Compiling a std::regex usually costs
+     *        more than using it, so share one cache across calls that reuse
+     *        the same patterns. Entries are handed out as shared pointers and
+     *        stay valid after being evicted.
+     */
+    class regex_cache
+    {
+    public:
+        /**
+         * @param capacity - maximum number of compiled patterns kept (at least 1).
+         */
+        explicit regex_cache(size_t capacity = 64) : capacity_(std::max<size_t>(capacity, 1))
+        {
+        }
+
+        regex_cache(const regex_cache &) = delete;
+        regex_cache & operator=(const regex_cache &) = delete;
+
+        /**
+         * @brief Returns the compiled pattern, compiling and caching it on a
+         *        miss. Throws std::regex_error if pattern is invalid.
+         * @param pattern - regular expression.
+         * @param flags - std::regex syntax flags.
+         * @return Shared pointer to the compiled regex.
+         */
+        std::shared_ptr<const std::regex> get(const std::string & pattern,
+                                              std::regex::flag_type flags = std::regex::ECMAScript)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                const auto found = index_.find(key_view { pattern, flags });
+                if (found != index_.end())
+                {
+                    ++hits_;
+                    entries_.splice(entries_.begin(), entries_, found->second);
+                    return found->second->compiled;
+                }
+                ++misses_;
+            }
+
+            // Compile without holding the lock; a concurrent miss on the
+            // same key compiles it twice and keeps whichever lands first.
+            auto compiled = std::make_shared<const std::regex>(pattern, flags);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto found = index_.find(key_view { pattern, flags });
+            if (found != index_.end())
+            {
+                entries_.splice(entries_.begin(), entries_, found->second);
+                return found->second->compiled;
+            }
+
+            entries_.push_front(entry { pattern, flags, compiled });
+            index_.emplace(key_view { entries_.front().pattern, flags }, entries_.begin());
+            if (entries_.size() > capacity_)
+            {
+                index_.erase(key_view { entries_.back().pattern, entries_.back().flags });
+                entries_.pop_back();
+            }
+            return compiled;
+        }
+
+        //! Number of get calls answered from the cache.
+        size_t hits() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return hits_;
+        }
+
+        //! Number of get calls that had to compile.
+        size_t misses() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return misses_;
+        }
+
+        //! Number of cached patterns.
+        size_t size() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entries_.size();
+        }
+
+        //! Maximum number of cached patterns.
+        size_t capacity() const
+        {
+            return capacity_;
+        }
+
+        //! Drops all cached patterns and resets the counters.
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            index_.clear();
+            entries_.clear();
+            hits_   = 0;
+            misses_ = 0;
+        }
+
+    private:
+        struct entry
+        {
+            std::string                       pattern;
+            std::regex::flag_type             flags;
+            std::shared_ptr<const std::regex> compiled;
+        };
+
+        // Views the pattern owned by the list entry, so lookups do not allocate.
+        struct key_view
+        {
+            std::string_view      pattern;
+            std::regex::flag_type flags;
+
+            bool operator<(const key_view & other) const
+            {
+                return flags != other.flags ? flags < other.flags : pattern < other.pattern;
+            }
+        };
+
+        const size_t                                              capacity_;
+        mutable std::mutex                                        mutex_;
+        std::list<entry>                                          entries_;
+        std::map<key_view, std::list<entry>::iterator>            index_;
+        size_t                                                    hits_   = 0;
+        size_t                                                    misses_ = 0;
+    };
+
+    namespace detail
+    {
+        // Byte-level regex engine behind dfa_regex. The pattern is parsed into
+        // a small syntax tree, compiled into Thompson NFAs (a forward and a
+        // reversed copy) and run through DFAs whose states are built on first
+        // use. Nothing recurses on the input, so stack use is independent of
+        // its length.
+
+        using regex_byte_set = std::bitset<256>;
+
+        struct regex_node
+        {
+            enum class kind : uint8_t
+            {
+                empty,
+                bytes,
+                concat,
+                alternate,
+                repeat,
+                text_start,
+                text_end
+            };
+
+            kind                  type   = kind::empty;
+            bool                  greedy = true;
+            uint32_t              set    = 0;
+            uint32_t              min    = 0;
+            uint32_t              max    = 0;
+            std::vector<uint32_t> children;
+        };
+
+        // Recursive descent parser for the supported ECMAScript subset: literals
+        // and escapes, '.', bracket classes with ranges and \d \w \s, groups
+        // (captures are not tracked), alternation, greedy and lazy quantifiers
+        // and the ^ $ anchors. Anything else throws std::regex_error.
+        class regex_parser
+        {
+        public:
+            static constexpr uint32_t unbounded  = std::numeric_limits<uint32_t>::max();
+            static constexpr uint32_t max_repeat = 1000;
+
+            regex_parser(std::string_view pattern, bool icase, std::vector<regex_node> & nodes,
+                         std::vector<regex_byte_set> & sets)
+                : pattern_(pattern), icase_(icase), nodes_(nodes), sets_(sets)
+            {
+            }
+
+            //! Parses the whole pattern and returns its root node.
+            uint32_t parse()
+            {
+                const uint32_t root = parse_alternation(0);
+                if (!at_end())
+                {
+                    throw std::regex_error(std::regex_constants::error_paren);
+                }
+                return root;
+            }
+
+        private:
+            static constexpr size_t max_depth = 256;
+
+            bool at_end() const
+            {
+                return pos_ == pattern_.size();
+            }
+
+            char peek() const
+            {
+                return pattern_[pos_];
+            }
+
+            uint32_t add_node(regex_node node)
+            {
+                nodes_.push_back(std::move(node));
+                return static_cast<uint32_t>(nodes_.size() - 1);
+            }
+
+            uint32_t add_node(regex_node::kind type)
+            {
+                regex_node node;
+                node.type = type;
+                return add_node(std::move(node));
+            }
+
+            uint32_t add_bytes(regex_byte_set set)
+            {
+                fold_case(set);
+                sets_.push_back(set);
+
+                regex_node node;
+                node.type = regex_node::kind::bytes;
+                node.set  = static_cast<uint32_t>(sets_.size() - 1);
+                return add_node(std::move(node));
+            }
+
+            void fold_case(regex_byte_set & set) const
+            {
+                if (!icase_)
+                {
+                    return;
+                }
+                for (size_t c = 'a'; c <= 'z'; ++c)
+                {
+                    if (set[c] || set[c - 0x20])
+                    {
+                        set.set(c);
+                        set.set(c - 0x20);
+                    }
+                }
+            }
+
+            uint32_t parse_alternation(size_t depth)
+            {
+                if (depth > max_depth)
+                {
+                    throw std::regex_error(std::regex_constants::error_complexity);
+                }
+
+                std::vector<uint32_t> alternatives { parse_concat(depth) };
+                while (!at_end() && peek() == '|')
+                {
+                    ++pos_;
+                    alternatives.push_back(parse_concat(depth));
+                }
+                if (alternatives.size() == 1)
+                {
+                    return alternatives.front();
+                }
+
+                regex_node node;
+                node.type     = regex_node::kind::alternate;
+                node.children = std::move(alternatives);
+                return add_node(std::move(node));
+            }
+
+            uint32_t parse_concat(size_t depth)
+            {
+                regex_node node;
+                node.type = regex_node::kind::concat;
+                while (!at_end() && peek() != '|' && peek() != ')')
+                {
+                    node.children.push_back(parse_repeat(depth));
+                }
+                if (node.children.size() == 1)
+                {
+                    return node.children.front();
+                }
+                return add_node(std::move(node));
+            }
+
+            uint32_t parse_repeat(size_t depth)
+            {
+                const char     first = peek();
+                const uint32_t atom  = parse_atom(depth);
+                if (at_end())
+                {
+                    return atom;
+                }
+
+                uint32_t min = 0;
+                uint32_t max = unbounded;
+                switch (peek())
+                {
+                case '*':
+                    ++pos_;
+                    break;
+                case '+':
+                    ++pos_;
+                    min = 1;
+                    break;
+                case '?':
+                    ++pos_;
+                    max = 1;
+                    break;
+                case '{':
+                    parse_braces(min, max);
+                    break;
+                default:
+                    return atom;
+                }
+
+                if (first == '^' || first == '$')
+                {
+                    throw std::regex_error(std::regex_constants::error_badrepeat);
+                }
+
+                regex_node node;
+                node.type = regex_node::kind::repeat;
+                node.min  = min;
+                node.max  = max;
+                node.children.push_back(atom);
+                if (!at_end() && peek() == '?')
+                {
+                    ++pos_;
+                    node.greedy = false;
+                }
+                if (!at_end() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{'))
+                {
+                    throw std::regex_error(std::regex_constants::error_badrepeat);
+                }
+                return add_node(std::move(node));
+            }
+
+            void parse_braces(uint32_t & min, uint32_t & max)
+            {
+                ++pos_;
+                min = parse_count();
+                max = min;
+                if (!at_end() && peek() == ',')
+                {
+                    ++pos_;
+                    max = !at_end() && peek() == '}' ? unbounded : parse_count();
+                }
+                if (at_end() || peek() != '}')
+                {
+                    throw std::regex_error(std::regex_constants::error_brace);
+                }
+                ++pos_;
+                if (max < min)
+                {
+                    throw std::regex_error(std::regex_constants::error_badbrace);
+                }
+            }
+
+            uint32_t parse_count()
+            {
+                if (at_end() || !is_digit(peek()))
+                {
+                    throw std::regex_error(std::regex_constants::error_badbrace);
+                }
+                uint32_t count = 0;
+                for (; !at_end() && is_digit(peek()); ++pos_)
+                {
+                    count = count * 10 + static_cast<uint32_t>(peek() - '0');
+                    if (count > max_repeat)
+                    {
+                        throw std::regex_error(std::regex_constants::error_complexity);
+                    }
+                }
+                return count;
+            }
+
+            uint32_t parse_atom(size_t depth)
+            {
+                const char c = pattern_[pos_++];
+                switch (c)
+                {
+                case '(':
+                {
+                    if (!at_end() && peek() == '?')
+                    {
+                        // Only non-capturing groups; lookarounds need backtracking.
+                        if (pos_ + 1 >= pattern_.size() || pattern_[pos_ + 1] != ':')
+                        {
+                            throw std::regex_error(std::regex_constants::error_complexity);
+                        }
+                        pos_ += 2;
+                    }
+                    const uint32_t inner = parse_alternation(depth + 1);
+                    if (at_end() || peek() != ')')
+                    {
+                        throw std::regex_error(std::regex_constants::error_paren);
+                    }
+                    ++pos_;
+                    return inner;
+                }
+                case '^':
+                    return add_node(regex_node::kind::text_start);
+                case '$':
+                    return add_node(regex_node::kind::text_end);
+                case '.':
+                {
+                    regex_byte_set set;
+                    set.set();
+                    set.reset('\n');
+                    set.reset('\r');
+                    return add_bytes(set);
+                }
+                case '[':
+                    return add_bytes(parse_class());
+                case '\\':
+                {
+                    if (at_end())
+                    {
+                        throw std::regex_error(std::regex_constants::error_escape);
+                    }
+                    if (peek() == 'b' || peek() == 'B')
+                    {
+                        throw std::regex_error(std::regex_constants::error_complexity);
+                    }
+                    if (peek() >= '1' && peek() <= '9')
+                    {
+                        throw std::regex_error(std::regex_constants::error_backref);
+                    }
+                    regex_byte_set set;
+                    parse_escape(set, false);
+                    return add_bytes(set);
+                }
+                case '*':
+                case '+':
+                case '?':
+                case '{':
+                    throw std::regex_error(std::regex_constants::error_badrepeat);
+                default:
+                {
+                    regex_byte_set set;
+                    set.set(static_cast<unsigned char>(c));
+                    return add_bytes(set);
+                }
+                }
+            }
+
+            regex_byte_set parse_class()
+            {
+                regex_byte_set set;
+                const bool negate = !at_end() && peek() == '^';
+                if (negate)
+                {
+                    ++pos_;
+                }
+
+                for (;;)
+                {
+                    if (at_end())
+                    {
+                        throw std::regex_error(std::regex_constants::error_brack);
+                    }
+                    if (peek() == ']')
+                    {
+                        ++pos_;
+                        break;
+                    }
+
+                    const int lo = parse_class_atom(set);
+                    if (pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']')
+                    {
+                        ++pos_;
+                        const int hi = parse_class_atom(set);
+                        if (lo < 0 || hi < 0 || lo > hi)
+                        {
+                            throw std::regex_error(std::regex_constants::error_range);
+                        }
+                        for (int b = lo; b <= hi; ++b)
+                        {
+                            set.set(static_cast<size_t>(b));
+                        }
+                    }
+                }
+
+                // Fold before complementing, so [^a] excludes 'A' too.
+                fold_case(set);
+                return negate ? ~set : set;
+            }
+
+            // Adds one class member to set; returns its byte, or -1 for \d \w \s.
+            int parse_class_atom(regex_byte_set & set)
+            {
+                const char c = pattern_[pos_++];
+                if (c != '\\')
+                {
+                    set.set(static_cast<unsigned char>(c));
+                    return static_cast<unsigned char>(c);
+                }
+                if (at_end())
+                {
+                    throw std::regex_error(std::regex_constants::error_escape);
+                }
+                return parse_escape(set, true);
+            }
+
+            // Parses the escape after a backslash into set; returns its byte,
+            // or -1 for the \d \w \s families.
+            int parse_escape(regex_byte_set & set, bool in_class)
+            {
+                const char c = pattern_[pos_++];
+                regex_byte_set family;
+                switch (c)
+                {
+                case 'd':
+                case 'D':
+                    for (size_t b = '0'; b <= '9'; ++b) family.set(b);
+                    break;
+                case 'w':
+                case 'W':
+                    for (size_t b = 0; b < 256; ++b)
+                    {
+                        family[b] = std::isalnum(static_cast<int>(b)) != 0 && b < 0x80;
+                    }
+                    family.set('_');
+                    break;
+                case 's':
+                case 'S':
+                    for (const char space : { ' ', '\t', '\n', '\v', '\f', '\r' }) family.set(static_cast<unsigned char>(space));
+                    break;
+                default:
+                {
+                    const int byte = parse_escaped_byte(c, in_class);
+                    set.set(static_cast<size_t>(byte));
+                    return byte;
+                }
+                }
+
+                set |= std::isupper(static_cast<unsigned char>(c)) ? ~family : family;
+                return -1;
+            }
+
+            int parse_escaped_byte(char c, bool in_class)
+            {
+                switch (c)
+                {
+                case 't': return '\t';
+                case 'n': return '\n';
+                case 'v': return '\v';
+                case 'f': return '\f';
+                case 'r': return '\r';
+                case '0': return 0;
+                case 'b':
+                    if (in_class) return '\b';
+                    break;
+                case 'c':
+                    if (!at_end() && std::isalpha(static_cast<unsigned char>(peek())) && static_cast<unsigned char>(peek()) < 0x80)
+                    {
+                        return pattern_[pos_++] % 32;
+                    }
+                    break;
+                case 'x':
+                case 'u':
+                {
+                    const size_t digits = c == 'x' ? 2 : 4;
+                    if (pattern_.size() - pos_ < digits)
+                    {
+                        break;
+                    }
+                    int value = 0;
+                    for (size_t i = 0; i < digits; ++i)
+                    {
+                        const int digit = hex_digit_value(pattern_[pos_ + i]);
+                        if (digit < 0)
+                        {
+                            throw std::regex_error(std::regex_constants::error_escape);
+                        }
+                        value = value * 16 + digit;
+                    }
+                    // The engine works on bytes; wider code units cannot be matched.
+                    if (value > 0xFF)
+                    {
+                        break;
+                    }
+                    pos_ += digits;
+                    return value;
+                }
+                default:
+                    // Identity escapes are limited to punctuation, as in ECMAScript.
+                    if (!std::isalnum(static_cast<unsigned char>(c)))
+                    {
+                        return static_cast<unsigned char>(c);
+                    }
+                    break;
+                }
+                throw std::regex_error(std::regex_constants::error_escape);
+            }
+
+            std::string_view              pattern_;
+            size_t                        pos_ = 0;
+            bool                          icase_;
+            std::vector<regex_node> &     nodes_;
+            std::vector<regex_byte_set> & sets_;
+        };
+
+        struct regex_nfa_state
+        {
+            enum class kind : uint8_t
+            {
+                consume,
+                split,
+                text_start,
+                text_end,
+                match,
+                fail
+            };
+
+            kind     type = kind::match;
+            uint32_t out  = 0; // consume, split (preferred branch), assertions
+            uint32_t alt  = 0; // split
+            uint32_t set  = 0; // consume
+        };
+
+        // Compiled pattern shared by all DFAs of one dfa_regex: the NFA states,
+        // the byte classes (bytes that no set tells apart) and which sets
+        // contain which class.
+        class regex_program
+        {
+        public:
+            static constexpr size_t max_states = size_t(1) << 18;
+
+            regex_program(std::string_view pattern, bool icase)
+            {
+                std::vector<regex_node>     nodes;
+                std::vector<regex_byte_set> sets;
+                const uint32_t root = regex_parser(pattern, icase, nodes, sets).parse();
+
+                regex_byte_set any;
+                any.set();
+                sets.push_back(any);
+                build_classes(sets);
+
+                fail_ = add_state(regex_nfa_state::kind::fail);
+                const uint32_t forward_match = add_state(regex_nfa_state::kind::match);
+                const uint32_t reverse_match = add_state(regex_nfa_state::kind::match);
+                forward_entry_  = compile(nodes, root, forward_match, forward_match, false);
+                nonempty_entry_ = compile(nodes, root, forward_match, fail_, false);
+                reverse_entry_ = compile(nodes, root, reverse_match, reverse_match, true);
+
+                // Unanchored search: (?:.|\n)*? in front, i.e. prefer the pattern
+                // here and only then skip a byte and retry.
+                search_entry_ = add_state(regex_nfa_state::kind::split);
+                const uint32_t skip = add_state(regex_nfa_state::kind::consume, search_entry_);
+                states_[skip].set          = static_cast<uint32_t>(sets.size() - 1);
+                states_[search_entry_].out = forward_entry_;
+                states_[search_entry_].alt = skip;
+            }
+
+            const std::vector<regex_nfa_state> & states() const
+            {
+                return states_;
+            }
+
+            //! Anchored entry of the pattern.
+            uint32_t forward_entry() const
+            {
+                return forward_entry_;
+            }
+
+            //! Anchored entry of the pattern restricted to non-empty matches.
+            uint32_t nonempty_entry() const
+            {
+                return nonempty_entry_;
+            }
+
+            //! Entry that may start the match at any later byte.
+            uint32_t search_entry() const
+            {
+                return search_entry_;
+            }
+
+            //! Anchored entry of the reversed pattern.
+            uint32_t reverse_entry() const
+            {
+                return reverse_entry_;
+            }
+
+            const std::array<uint16_t, 256> & classes() const
+            {
+                return classes_;
+            }
+
+            size_t class_count() const
+            {
+                return class_count_;
+            }
+
+            bool contains(uint32_t set, size_t byte_class) const
+            {
+                return members_[set * class_count_ + byte_class] != 0;
+            }
+
+        private:
+            uint32_t add_state(regex_nfa_state::kind type, uint32_t out = 0, uint32_t alt = 0)
+            {
+                if (states_.size() >= max_states)
+                {
+                    throw std::regex_error(std::regex_constants::error_complexity);
+                }
+                regex_nfa_state state;
+                state.type = type;
+                state.out  = out;
+                state.alt  = alt;
+                states_.push_back(state);
+                return static_cast<uint32_t>(states_.size() - 1);
+            }
+
+            // Builds the NFA for node and returns its entry. Paths leave to
+            // next if the node consumed a byte and to next_empty if it did not,
+            // so next_empty == fail_ keeps only the non-empty matches, in the
+            // same order. The reversed NFA accepts the mirrored strings; anchors
+            // keep their meaning in terms of text positions.
+            uint32_t compile(const std::vector<regex_node> & nodes, uint32_t id, uint32_t next, uint32_t next_empty, bool reverse)
+            {
+                const regex_node & node = nodes[id];
+                switch (node.type)
+                {
+                case regex_node::kind::empty:
+                    return next_empty;
+                case regex_node::kind::bytes:
+                {
+                    const uint32_t state = add_state(regex_nfa_state::kind::consume, next);
+                    states_[state].set   = node.set;
+                    return state;
+                }
+                case regex_node::kind::text_start:
+                    return add_state(regex_nfa_state::kind::text_start, next_empty);
+                case regex_node::kind::text_end:
+                    return add_state(regex_nfa_state::kind::text_end, next_empty);
+                case regex_node::kind::concat:
+                {
+                    uint32_t rest       = next;
+                    uint32_t rest_empty = next_empty;
+                    const auto & children = node.children;
+                    for (size_t i = 0; i < children.size(); ++i)
+                    {
+                        const uint32_t child = reverse ? children[i] : children[children.size() - 1 - i];
+                        step(nodes, child, rest, rest_empty, i + 1 < children.size(), reverse);
+                    }
+                    return rest_empty;
+                }
+                case regex_node::kind::alternate:
+                {
+                    // Earlier alternatives are preferred.
+                    uint32_t entry = compile(nodes, node.children.back(), next, next_empty, reverse);
+                    for (size_t i = node.children.size() - 1; i-- > 0;)
+                    {
+                        entry = add_state(regex_nfa_state::kind::split, compile(nodes, node.children[i], next, next_empty, reverse), entry);
+                    }
+                    return entry;
+                }
+                case regex_node::kind::repeat:
+                {
+                    // ECMAScript fails an iteration past the minimum that
+                    // matches empty, so those bodies only keep their non-empty
+                    // paths. Each one consumed, so the next iteration follows
+                    // on as if the node had consumed.
+                    const uint32_t child      = node.children.front();
+                    uint32_t       tail       = next;
+                    uint32_t       tail_empty = next_empty;
+                    const auto     optional   = [&](uint32_t body, uint32_t skip)
+                    {
+                        return node.greedy ? add_state(regex_nfa_state::kind::split, body, skip)
+                                           : add_state(regex_nfa_state::kind::split, skip, body);
+                    };
+                    if (node.max == regex_parser::unbounded)
+                    {
+                        const uint32_t loop = add_state(regex_nfa_state::kind::split);
+                        const uint32_t body = compile(nodes, child, loop, fail_, reverse);
+                        states_[loop].out   = node.greedy ? body : next;
+                        states_[loop].alt   = node.greedy ? next : body;
+                        tail                = loop;
+                        tail_empty          = next == next_empty ? loop : optional(body, next_empty);
+                    }
+                    else
+                    {
+                        for (uint32_t k = node.min; k < node.max; ++k)
+                        {
+                            const uint32_t body = compile(nodes, child, tail, fail_, reverse);
+                            tail       = optional(body, next);
+                            tail_empty = next == next_empty ? tail : optional(body, next_empty);
+                        }
+                    }
+                    for (uint32_t k = 0; k < node.min; ++k)
+                    {
+                        step(nodes, child, tail, tail_empty, k + 1 < node.min, reverse);
+                    }
+                    return tail_empty;
+                }
+                }
+                return next_empty;
+            }
+
+            // Puts child in front of a sequence whose entries are rest, once
+            // something was consumed, and rest_empty otherwise. rest is only
+            // kept up to date if more children will be put in front.
+            void step(const std::vector<regex_node> & nodes, uint32_t child, uint32_t & rest, uint32_t & rest_empty, bool more,
+                      bool reverse)
+            {
+                if (rest == rest_empty)
+                {
+                    rest = rest_empty = compile(nodes, child, rest, rest, reverse);
+                    return;
+                }
+                const uint32_t entry_empty = compile(nodes, child, rest, rest_empty, reverse);
+                rest       = more ? compile(nodes, child, rest, rest, reverse) : rest;
+                rest_empty = entry_empty;
+            }
+            // Partition refinement: bytes end up in one class exactly when every
+            // set either contains all of them or none.
+            void build_classes(const std::vector<regex_byte_set> & sets)
+            {
+                classes_.fill(0);
+                class_count_ = 1;
+                for (const regex_byte_set & set : sets)
+                {
+                    std::vector<int>          renumber(class_count_ * 2, -1);
+                    std::array<uint16_t, 256> refined {};
+                    size_t                    count = 0;
+                    for (size_t b = 0; b < 256; ++b)
+                    {
+                        int & target = renumber[classes_[b] * 2 + set[b]];
+                        if (target < 0)
+                        {
+                            target = static_cast<int>(count++);
+                        }
+                        refined[b] = static_cast<uint16_t>(target);
+                    }
+                    classes_     = refined;
+                    class_count_ = count;
+                }
+
+                members_.assign(sets.size() * class_count_, 0);
+                for (size_t s = 0; s < sets.size(); ++s)
+                {
+                    for (size_t b = 0; b < 256; ++b)
+                    {
+                        members_[s * class_count_ + classes_[b]] = sets[s][b];
+                    }
+                }
+            }
+
+            std::vector<regex_nfa_state> states_;
+            std::array<uint16_t, 256>    classes_ {};
+            size_t                       class_count_ = 1;
+            std::vector<uint8_t>         members_;
+            uint32_t                     forward_entry_  = 0;
+            uint32_t                     nonempty_entry_ = 0;
+            uint32_t                     search_entry_   = 0;
+            uint32_t                     reverse_entry_  = 0;
+            uint32_t                     fail_           = 0;
+        };
+
+        // DFA over a regex_program whose states are built the first time a scan
+        // reaches them. A state is the ordered list of NFA states live at one
+        // position. With leftmost_first the list is cut after the first match,
+        // which reproduces ECMAScript's preference for earlier alternatives and
+        // for greedy (or lazy) repetition. Assertions are only decided at the
+        // text boundaries: the leading one (^ forward, $ reversed) when the scan
+        // starts there, the trailing one when it runs into the far end. When the
+        // cache outgrows its budget it is flushed and rebuilt from the current
+        // state, so memory stays bounded and every byte still costs at most one
+        // NFA step.
+        class regex_lazy_dfa
+        {
+        public:
+            static constexpr uint32_t dead = 0;
+
+            regex_lazy_dfa(const regex_program & program, uint32_t entry, bool reverse, bool leftmost_first)
+                : program_(program),
+                  classes_(program.classes()),
+                  class_count_(program.class_count()),
+                  entry_(entry),
+                  leading_(reverse ? regex_nfa_state::kind::text_end : regex_nfa_state::kind::text_start),
+                  leftmost_first_(leftmost_first),
+                  max_states_(std::max<size_t>(64, cache_budget / (class_count_ * sizeof(uint32_t) + 64))),
+                  marks_(program.states().size(), 0)
+            {
+                flush();
+            }
+
+            //! State before the first byte of a scan; at_boundary if the leading assertion holds there.
+            uint32_t start(bool at_boundary)
+            {
+                uint32_t & cached = starts_[at_boundary];
+                if (cached == unknown)
+                {
+                    next_generation();
+                    step_.clear();
+                    closure(entry_, at_boundary, false, step_);
+                    cached = intern(step_);
+                }
+                return cached;
+            }
+
+            uint32_t next(uint32_t state, unsigned char byte)
+            {
+                const size_t   byte_class = classes_[byte];
+                const uint32_t known      = transitions_[state * class_count_ + byte_class];
+                if (known != unknown)
+                {
+                    return known;
+                }
+
+                next_generation();
+                step_.clear();
+                const auto & states = program_.states();
+                for (uint32_t i = offsets_[state]; i < offsets_[state + 1]; ++i)
+                {
+                    const regex_nfa_state & nfa = states[lists_[i]];
+                    if (nfa.type == regex_nfa_state::kind::consume && program_.contains(nfa.set, byte_class) &&
+                        closure(nfa.out, false, false, step_))
+                    {
+                        break;
+                    }
+                }
+
+                const size_t   flushes = flushes_;
+                const uint32_t target  = intern(step_);
+                if (flushes == flushes_)
+                {
+                    transitions_[state * class_count_ + byte_class] = target;
+                }
+                return target;
+            }
+
+            bool is_match(uint32_t state) const
+            {
+                return matches_[state] != 0;
+            }
+
+            //! Whether state matches at the far text boundary; empty_text if the leading assertion holds there too.
+            bool is_match_at_end(uint32_t state, bool empty_text)
+            {
+                uint8_t &     cached = at_end_[state];
+                const uint8_t known  = empty_text ? 4 : 1;
+                if ((cached & known) == 0)
+                {
+                    next_generation();
+                    step_.clear();
+                    for (uint32_t i = offsets_[state]; i < offsets_[state + 1]; ++i)
+                    {
+                        if (closure(lists_[i], empty_text, true, step_))
+                        {
+                            break;
+                        }
+                    }
+                    const bool found = std::any_of(step_.begin(), step_.end(), [&](uint32_t id)
+                                                   { return program_.states()[id].type == regex_nfa_state::kind::match; });
+                    cached = static_cast<uint8_t>(cached | known | (found ? known << 1 : 0));
+                }
+                return (cached & (known << 1)) != 0;
+            }
+
+        private:
+            static constexpr uint32_t unknown      = std::numeric_limits<uint32_t>::max();
+            static constexpr size_t   cache_budget = size_t(2) << 20;
+
+            void next_generation()
+            {
+                if (++generation_ == 0)
+                {
+                    std::fill(marks_.begin(), marks_.end(), 0);
+                    generation_ = 1;
+                }
+            }
+
+            // Appends the states reachable from id without consuming a byte, in
+            // preference order. Returns true if the list was cut at a match.
+            bool closure(uint32_t id, bool leading_holds, bool trailing_holds, std::vector<uint32_t> & list)
+            {
+                const auto & states = program_.states();
+                stack_.push_back(id);
+                while (!stack_.empty())
+                {
+                    const uint32_t current = stack_.back();
+                    stack_.pop_back();
+                    if (marks_[current] == generation_)
+                    {
+                        continue;
+                    }
+                    marks_[current] = generation_;
+
+                    const regex_nfa_state & state = states[current];
+                    switch (state.type)
+                    {
+                    case regex_nfa_state::kind::consume:
+                        list.push_back(current);
+                        break;
+                    case regex_nfa_state::kind::split:
+                        stack_.push_back(state.alt);
+                        stack_.push_back(state.out);
+                        break;
+                    case regex_nfa_state::kind::match:
+                        list.push_back(current);
+                        if (leftmost_first_)
+                        {
+                            stack_.clear();
+                            return true;
+                        }
+                        break;
+                    case regex_nfa_state::kind::fail:
+                        break;
+                    default:
+                        if (state.type == leading_ ? leading_holds : trailing_holds)
+                        {
+                            stack_.push_back(state.out);
+                        }
+                        else
+                        {
+                            list.push_back(current);
+                        }
+                        break;
+                    }
+                }
+                return false;
+            }
+
+            uint32_t intern(const std::vector<uint32_t> & list)
+            {
+                key_.assign(reinterpret_cast<const char *>(list.data()), list.size() * sizeof(uint32_t));
+                const auto found = index_.find(key_);
+                if (found != index_.end())
+                {
+                    return found->second;
+                }
+                if (matches_.size() >= max_states_)
+                {
+                    flush();
+                    if (list.empty())
+                    {
+                        return dead;
+                    }
+                }
+                return add(list, key_);
+            }
+
+            uint32_t add(const std::vector<uint32_t> & list, const std::string & key)
+            {
+                const uint32_t id = static_cast<uint32_t>(matches_.size());
+                index_.emplace(key, id);
+                lists_.insert(lists_.end(), list.begin(), list.end());
+                offsets_.push_back(static_cast<uint32_t>(lists_.size()));
+                transitions_.resize(transitions_.size() + class_count_, unknown);
+                matches_.push_back(std::any_of(list.begin(), list.end(), [&](uint32_t state)
+                                               { return program_.states()[state].type == regex_nfa_state::kind::match; }));
+                at_end_.push_back(0);
+                return id;
+            }
+
+            void flush()
+            {
+                ++flushes_;
+                index_.clear();
+                lists_.clear();
+                offsets_.assign(1, 0);
+                transitions_.clear();
+                matches_.clear();
+                at_end_.clear();
+                starts_[0] = starts_[1] = unknown;
+                add({}, std::string());
+            }
+
+            const regex_program &                  program_;
+            const std::array<uint16_t, 256>        classes_;
+            const size_t                           class_count_;
+            const uint32_t                         entry_;
+            const regex_nfa_state::kind            leading_;
+            const bool                             leftmost_first_;
+            const size_t                           max_states_;
+            std::unordered_map<std::string, uint32_t> index_;
+            std::vector<uint32_t>                  lists_;
+            std::vector<uint32_t>                  offsets_;
+            std::vector<uint32_t>                  transitions_;
+            std::vector<uint8_t>                   matches_;
+            std::vector<uint8_t>                   at_end_;
+            uint32_t                               starts_[2] = { unknown, unknown };
+            size_t                                 flushes_   = 0;
+            std::vector<uint32_t>                  marks_;
+            uint32_t                               generation_ = 0;
+            std::vector<uint32_t>                  stack_;
+            std::vector<uint32_t>                  step_;
+            std::string                            key_;
+        };
+
+        // The DFAs one dfa_regex runs: anchored for whole-string matches,
+        // unanchored leftmost-first to find where the preferred match ends,
+        // reversed to find where it starts, and anchored leftmost-first over
+        // the non-empty matches for the retry after an empty one.
+        struct regex_dfa_set
+        {
+            explicit regex_dfa_set(const regex_program & program)
+                : whole(program, program.forward_entry(), false, false),
+                  search(program, program.search_entry(), false, true),
+                  reverse(program, program.reverse_entry(), true, false),
+                  nonempty(program, program.nonempty_entry(), false, true)
+            {
+            }
+
+            regex_lazy_dfa whole;
+            regex_lazy_dfa search;
+            regex_lazy_dfa reverse;
+            regex_lazy_dfa nonempty;
+        };
+
+        // Idle regex_dfa_sets of one dfa_regex. Each call takes one for its
+        // own use and gives it back, so concurrent calls run on separate
+        // caches and later calls reuse the states built by earlier ones.
+        class regex_dfa_pool
+        {
+        public:
+            explicit regex_dfa_pool(const regex_program & program) : program_(program)
+            {
+                idle_.push_back(std::make_unique<regex_dfa_set>(program_));
+            }
+
+            std::unique_ptr<regex_dfa_set> acquire()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!idle_.empty())
+                    {
+                        std::unique_ptr<regex_dfa_set> dfas = std::move(idle_.back());
+                        idle_.pop_back();
+                        return dfas;
+                    }
+                }
+                return std::make_unique<regex_dfa_set>(program_);
+            }
+
+            void release(std::unique_ptr<regex_dfa_set> dfas) noexcept
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                try
+                {
+                    idle_.push_back(std::move(dfas));
+                }
+                catch (...)
+                {
+                    // Out of memory: drop the cache rather than fail the call.
+                }
+            }
+
+        private:
+            const regex_program &                       program_;
+            std::mutex                                  mutex_;
+            std::vector<std::unique_ptr<regex_dfa_set>> idle_;
+        };
+
+        // End of the preferred match starting at or after pos, or npos. With
+        // earliest set, returns as soon as any match is known to exist.
+        inline size_t regex_search_end(regex_lazy_dfa & dfa, std::string_view text, size_t pos, bool earliest)
+        {
+            uint32_t state = dfa.start(pos == 0);
+            size_t   end   = dfa.is_match(state) ? pos : std::string_view::npos;
+            if (earliest && end != std::string_view::npos)
+            {
+                return end;
+            }
+            for (size_t i = pos; i < text.size(); ++i)
+            {
+                state = dfa.next(state, static_cast<unsigned char>(text[i]));
+                if (state == regex_lazy_dfa::dead)
+                {
+                    return end;
+                }
+                if (dfa.is_match(state))
+                {
+                    end = i + 1;
+                    if (earliest)
+                    {
+                        return end;
+                    }
+                }
+            }
+            return dfa.is_match_at_end(state, text.empty()) ? text.size() : end;
+        }
+
+        // Leftmost start in [pos, end] of a match ending at end, scanning backwards.
+        inline size_t regex_match_start(regex_lazy_dfa & dfa, std::string_view text, size_t pos, size_t end)
+        {
+            uint32_t state = dfa.start(end == text.size());
+            size_t   start = dfa.is_match(state) ? end : std::string_view::npos;
+            for (size_t i = end; i > pos; --i)
+            {
+                state = dfa.next(state, static_cast<unsigned char>(text[i - 1]));
+                if (state == regex_lazy_dfa::dead)
+                {
+                    return start;
+                }
+                if (dfa.is_match(state))
+                {
+                    start = i - 1;
+                }
+            }
+            return pos == 0 && dfa.is_match_at_end(state, text.empty()) ? 0 : start;
+        }
+    }
+
+    /**
+     * @brief Regular expression compiled for strutil's built-in DFA engine, a
+     *        drop-in alternative to std::regex for the matches, regex_split and
+     *        regex_split_map overloads that take one. Matching never
+     *        backtracks: each call runs in time linear in the bytes it
+     *        examines and uses no stack proportional to the input, so
+     *        multi-megabyte inputs are safe.
+     *
+     *        Supported syntax is the ECMAScript subset: literals and escapes
+     *        (\\t \\n \\xHH ...), '.', bracket classes with ranges and \\d \\w
+     *        \\s, groups, alternation, greedy and lazy * + ? {n,m}, and ^ $
+     *        anchoring at the ends of the input. Matches are found with
+     *        ECMAScript's leftmost, first-alternative-preferred semantics,
+     *        including its rule that a repetition past the quantifier's
+     *        minimum may not match the empty string.
+     *        Backreferences, lookarounds and \\b throw std::regex_error, as do
+     *        malformed patterns. Matching works on bytes; of the flags only
+     *        std::regex::icase (ASCII case folding) has an effect.
+     *
+     *        States are built lazily into caches bounded in size. Copies
+     *        share the compiled pattern and a pool of caches: concurrent calls
+     *        each take a cache of their own from the pool and return it
+     *        afterwards, so they neither wait for one another nor start over
+     *        from an empty cache.
+     */
+    class dfa_regex
+    {
+    public:
+        /**
+         * @param pattern - regular expression.
+         * @param flags - std::regex syntax flags; only icase is honoured.
+         */
+        explicit dfa_regex(std::string_view pattern, std::regex::flag_type flags = std::regex::ECMAScript)
+            : program_(std::make_shared<const detail::regex_program>(pattern, (flags & std::regex::icase) != 0)),
+              dfas_(std::make_shared<detail::regex_dfa_pool>(*program_))
+        {
+        }
+
+        /**
+         * @brief Checks if the whole of str matches.
+         * @param str - text to be checked.
+         * @return True if the pattern matches all of str.
+         */
+        bool matches(std::string_view str) const
+        {
+            return with_dfas([&](detail::regex_dfa_set & dfas)
+            {
+                uint32_t state = dfas.whole.start(true);
+                for (const char c : str)
+                {
+                    state = dfas.whole.next(state, static_cast<unsigned char>(c));
+                    if (state == detail::regex_lazy_dfa::dead)
+                    {
+                        return false;
+                    }
+                }
+                return dfas.whole.is_match_at_end(state, str.empty());
+            });
+        }
+
+        /**
+         * @brief Checks if some part of str matches.
+         * @param str - text to be searched.
+         * @return True if the pattern matches anywhere in str.
+         */
+        bool search(std::string_view str) const
+        {
+            return with_dfas([&](detail::regex_dfa_set & dfas)
+            {
+                return detail::regex_search_end(dfas.search, str, 0, true) != std::string_view::npos;
+            });
+        }
+
+        /**
+         * @brief Finds the first match starting at or after pos.
+         * @param str - text to be searched.
+         * @param pos - offset to start searching at.
+         * @return (offset, length) of the match, or std::nullopt if there is none.
+         */
+        std::optional<std::pair<size_t, size_t>> find(std::string_view str, size_t pos = 0) const
+        {
+            return with_dfas([&](detail::regex_dfa_set & dfas)
+            {
+                return find(dfas, str, pos);
+            });
+        }
+
+        friend std::vector<std::string> regex_split(const std::string & src, const dfa_regex & rgx, bool keep_empty);
+        friend std::vector<std::pair<std::string_view, std::string_view>> regex_split_pairs(std::string_view src,
+                                                                                            const dfa_regex & rgx);
+
+    private:
+        template <typename F>
+        std::invoke_result_t<F, detail::regex_dfa_set &> with_dfas(F && f) const
+        {
+            struct lease
+            {
+                detail::regex_dfa_pool &               pool;
+                std::unique_ptr<detail::regex_dfa_set> dfas;
+
+                ~lease()
+                {
+                    pool.release(std::move(dfas));
+                }
+            };
+            lease leased { *dfas_, dfas_->acquire() };
+            return f(*leased.dfas);
+        }
+
+        static std::optional<std::pair<size_t, size_t>> find(detail::regex_dfa_set & dfas, std::string_view str, size_t pos)
+        {
+            if (pos > str.size())
+            {
+                return std::nullopt;
+            }
+            const size_t end = detail::regex_search_end(dfas.search, str, pos, false);
+            if (end == std::string_view::npos)
+            {
+                return std::nullopt;
+            }
+            const size_t start = detail::regex_match_start(dfas.reverse, str, pos, end);
+            return std::make_pair(start, end - start);
+        }
+
+        // Calls f(offset, length) for each non-empty match, left to right.
+        // Like std::regex_iterator, an empty match is followed by a retry at
+        // the same offset for the preferred non-empty match there, and only
+        // if there is none does the search move one byte on.
+        template <typename F>
+        void for_each_match(std::string_view str, F && f) const
+        {
+            with_dfas([&](detail::regex_dfa_set & dfas)
+            {
+                size_t pos = 0;
+                while (auto found = find(dfas, str, pos))
+                {
+                    const size_t offset = found->first;
+                    size_t       length = found->second;
+                    if (length == 0)
+                    {
+                        const size_t end = detail::regex_search_end(dfas.nonempty, str, offset, false);
+                        if (end == std::string_view::npos)
+                        {
+                            pos = offset + 1;
+                            continue;
+                        }
+                        length = end - offset;
+                    }
+                    f(offset, length);
+                    pos = offset + length;
+                }
+            });
+        }
+
+        std::shared_ptr<const detail::regex_program> program_;
+        std::shared_ptr<detail::regex_dfa_pool>      dfas_;
+    };
+
+    /**
+     * @brief Splits input string using an already compiled regex as a delimiter.
+     * @param src - std::string that will be split.
+     * @param rgx - the delimiter regex.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> regex_split(const std::string& src, const std::regex& rgx, bool keep_empty = true)
+    {
+        std::vector<std::string> elems;
+        std::sregex_token_iterator iter(src.begin(), src.end(), rgx, -1);
+        std::sregex_token_iterator end;
+        while (iter != end)
+        {
+            if (keep_empty || iter->length() != 0)
+            {
+                elems.push_back(*iter);
+            }
+            ++iter;
+        }
+        return elems;
+    }
+
+    /**
+     * @brief Splits input string using regex as a delimiter.
+     * @param src - std::string that will be split.
+     * @param rgx_str - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> regex_split(const std::string& src, const std::string& rgx_str, bool keep_empty = true)
+    {
+        return regex_split(src, std::regex(rgx_str), keep_empty);
+    }
+
+    /**
+     * @brief Splits input string using regex as a delimiter, taking the
+     *        compiled regex from cache.
+     * @param src - std::string that will be split.
+     * @param rgx_str - the set of delimiter characters.
+     * @param cache - cache the compiled rgx_str is looked up in or added to.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> regex_split(const std::string& src, const std::string& rgx_str, regex_cache& cache, bool keep_empty = true)
+    {
+        return regex_split(src, *cache.get(rgx_str), keep_empty);
+    }
+
+    namespace detail
+    {
+        // Keeps the last pair of every run of equal keys after a stable sort,
+        // so later duplicates win as with repeated std::map assignment.
+        inline std::vector<std::pair<std::string_view, std::string_view>>
+        sorted_last_wins(std::vector<std::pair<std::string_view, std::string_view>> pairs)
+        {
+            std::stable_sort(pairs.begin(), pairs.end(), [](const auto & lhs, const auto & rhs)
+            {
+                return lhs.first < rhs.first;
+            });
+
+            size_t kept = 0;
+            for (size_t i = 0; i < pairs.size(); ++i)
+            {
+                if (i + 1 == pairs.size() || pairs[i + 1].first != pairs[i].first)
+                {
+                    pairs[kept++] = pairs[i];
+                }
+            }
+            pairs.resize(kept);
+            return pairs;
+        }
+
+        inline std::map<std::string, std::string>
+        to_string_map(const std::vector<std::pair<std::string_view, std::string_view>> & pairs)
+        {
+            std::map<std::string, std::string> dest;
+            for (const auto & [key, value] : pairs)
+            {
+                dest[std::string(key)] = std::string(value);
+            }
+            return dest;
+        }
+    }
+
+    /**
+     * @brief Splits input string_view using regex as a delimiter in a single
+     *        pass, pairing each match with the text up to the next match (or
+     *        the end). Nothing is copied: the views point into the memory viewed
+     *        by src, which must outlive the result.
+     * @param src - text that will be split.
+     * @param rgx - the delimiter regex.
+     * @return (match, following text) pairs in input order, duplicates included.
+     */
+    inline std::vector<std::pair<std::string_view, std::string_view>> regex_split_pairs(std::string_view src, const std::regex& rgx)
+    {
+        std::vector<std::pair<std::string_view, std::string_view>> pairs;
+        const std::cregex_iterator end;
+        for (std::cregex_iterator match(src.data(), src.data() + src.size(), rgx); match != end; ++match)
+        {
+            const size_t offset = static_cast<size_t>(match->position(0));
+            if (!pairs.empty())
+            {
+                const std::string_view & key = pairs.back().first;
+                const size_t value = static_cast<size_t>(key.data() - src.data()) + key.size();
+                pairs.back().second = src.substr(value, offset - value);
+            }
+            pairs.emplace_back(src.substr(offset, static_cast<size_t>(match->length(0))), std::string_view());
+        }
+        if (!pairs.empty())
+        {
+            const std::string_view & key = pairs.back().first;
+            pairs.back().second = src.substr(static_cast<size_t>(key.data() - src.data()) + key.size());
+        }
+        return pairs;
+    }
+
+    /**
+     * @brief Splits input string_view using regex as a delimiter into a flat
+     *        map: (match, following text) pairs sorted by match, where a later
+     *        duplicate replaces an earlier one. Look keys up with
+     *        std::lower_bound. The views point into the memory viewed by src,
+     *        which must outlive the result.
+     * @param src - text that will be split.
+     * @param rgx - the delimiter regex.
+     * @return Sorted (match, following text) pairs with unique keys.
+     */
+    inline std::vector<std::pair<std::string_view, std::string_view>> regex_split_map_view(std::string_view src, const std::regex& rgx)
+    {
+        return detail::sorted_last_wins(regex_split_pairs(src, rgx));
+    }
+
+    /**
+     * @brief Splits input string using an already compiled regex as a delimiter.
+     * @param src - std::string that will be split.
+     * @param rgx - the delimiter regex.
+     * @return Map of each matched delimiter to the text following it.
+     */
+    inline std::map<std::string, std::string> regex_split_map(const std::string& src, const std::regex& rgx)
+    {
+        return detail::to_string_map(regex_split_pairs(src, rgx));
+    }
+
+    /**
+     * @brief Splits input string using regex as a delimiter.
+     * @param src - std::string that will be split.
+     * @param dest - map of matched delimiter and those being splitted.
+     * @param rgx_str - the set of delimiter characters.
+     * @return True if the parsing is successfully done.
+     */
+    inline std::map<std::string, std::string> regex_split_map(const std::string& src, const std::string& rgx_str)
+    {
+        return regex_split_map(src, std::regex(rgx_str));
+    }
+
+    /**
+     * @brief Splits input string using regex as a delimiter, taking the
+     *        compiled regex from cache.
+     * @param src - std::string that will be split.
+     * @param rgx_str - the set of delimiter characters.
+     * @param cache - cache the compiled rgx_str is looked up in or added to.
+     * @return Map of each matched delimiter to the text following it.
+     */
+    inline std::map<std::string, std::string> regex_split_map(const std::string& src, const std::string& rgx_str, regex_cache& cache)
+    {
+        return regex_split_map(src, *cache.get(rgx_str));
+    }
+
+    /**
+     * @brief Splits input string using a dfa_regex as a delimiter. Unlike the
+     *        std::regex overloads, empty matches never delimit tokens.
+     * @param src - std::string that will be split.
+     * @param rgx - the delimiter regex.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> regex_split(const std::string& src, const dfa_regex& rgx, bool keep_empty = true)
+    {
+        std::vector<std::string> elems;
+        bool   matched = false;
+        size_t token   = 0;
+        rgx.for_each_match(src, [&](size_t offset, size_t length)
+        {
+            if (keep_empty || offset != token)
+            {
+                elems.emplace_back(src, token, offset - token);
+            }
+            matched = true;
+            token   = offset + length;
+        });
+
+        // Like std::sregex_token_iterator, an empty remainder after the last
+        // delimiter is dropped, but an empty input without delimiters is kept.
+        if (matched ? token != src.size() : keep_empty || !src.empty())
+        {
+            elems.emplace_back(src, token);
+        }
+        return elems;
+    }
+
+    /**
+     * @brief Splits input string_view using a dfa_regex as a delimiter in a
+     *        single pass, pairing each non-empty match with the text up to the
+     *        next one (or the end). The views point into the memory viewed by
+     *        src, which must outlive the result.
+     * @param src - text that will be split.
+     * @param rgx - the delimiter regex.
+     * @return (match, following text) pairs in input order, duplicates included.
+     */
+    inline std::vector<std::pair<std::string_view, std::string_view>> regex_split_pairs(std::string_view src, const dfa_regex& rgx)
+    {
+        std::vector<std::pair<std::string_view, std::string_view>> pairs;
+        size_t value = 0;
+        rgx.for_each_match(src, [&](size_t offset, size_t length)
+        {
+            if (!pairs.empty())
+            {
+                pairs.back().second = src.substr(value, offset - value);
+            }
+            pairs.emplace_back(src.substr(offset, length), std::string_view());
+            value = offset + length;
+        });
+        if (!pairs.empty())
+        {
+            pairs.back().second = src.substr(value);
+        }
+        return pairs;
+    }
+
+    /**
+     * @brief Splits input string_view using a dfa_regex as a delimiter into a
+     *        flat map sorted by match, where a later duplicate replaces an
+     *        earlier one. The views point into the memory viewed by src, which
+     *        must outlive the result.
+     * @param src - text that will be split.
+     * @param rgx - the delimiter regex.
+     * @return Sorted (match, following text) pairs with unique keys.
+     */
+    inline std::vector<std::pair<std::string_view, std::string_view>> regex_split_map_view(std::string_view src, const dfa_regex& rgx)
+    {
+        return detail::sorted_last_wins(regex_split_pairs(src, rgx));
+    }
+
+    /**
+     * @brief Splits input string using a dfa_regex as a delimiter.
+     * @param src - std::string that will be split.
+     * @param rgx - the delimiter regex.
+     * @return Map of each matched delimiter to the text following it.
+     */
+    inline std::map<std::string, std::string> regex_split_map(const std::string& src, const dfa_regex& rgx)
+    {
+        return detail::to_string_map(regex_split_pairs(src, rgx));
+    }
+
+    /**
+     * @brief Splits input std::string_view str using any delimiter in the given set
+     *        without copying the tokens. The returned views point into the memory
+     *        viewed by str, so that memory must outlive the result.
+     * @param str - std::string_view that will be split.
+     * @param delims - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string_view> split_any(std::string_view str, const char_set & delims, bool keep_empty = true)
+    {
+        std::vector<std::string_view> tokens;
+
+        size_t pos_start = 0, pos_end;
+        while ((pos_end = find_first_of(str, delims, pos_start)) != std::string_view::npos)
+        {
+            if (keep_empty || pos_end != pos_start)
+            {
+                tokens.push_back(str.substr(pos_start, pos_end - pos_start));
+            }
+            pos_start = pos_end + 1;
+        }
+
+        if (keep_empty || pos_start != str.size())
+        {
+            tokens.push_back(str.substr(pos_start));
+        }
+        return tokens;
+    }
+
+    /**
+     * @brief Splits input std::string_view str using any delimiter in the given set
+     *        without copying the tokens. The returned views point into the memory
+     *        viewed by str, so that memory must outlive the result.
+     * @param str - std::string_view that will be split.
+     * @param delims - the delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string_view> split_any(std::string_view str, std::string_view delims, bool keep_empty = true)
+    {
+        return split_any(str, char_set(delims), keep_empty);
+    }
+
+    /**
+     * @brief Splits input string using any delimiter in the given set.
+     * @param str - std::string that will be split.
+     * @param delims - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> split_any(const std::string & str, const std::string & delims, bool keep_empty = true)
+    {
+        const auto views = split_any(std::string_view(str), std::string_view(delims), keep_empty);
+        return std::vector<std::string>(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Splits input C string using any delimiter in the given set.
+     *        Disambiguates string literals between the std::string and
+     *        std::string_view overloads; tokens are returned as owned strings.
+     * @param str - C string that will be split.
+     * @param delims - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return vector of resulting tokens.
+     */
+    inline std::vector<std::string> split_any(const char * str, const std::string & delims, bool keep_empty = true)
+    {
+        return split_any(std::string(str), delims, keep_empty);
+    }
+
+    /**
+     * @brief Lazy range over the tokens of a std::string_view, split by a single
+     *        character, a delimiter string or any character of a delimiter set.
+     *        Tokens are produced one at a time as std::string_view, without any
+     *        heap allocation, so stopping early costs only the fields consumed.
+     *        Token semantics (including keep_empty) match split and split_any.
+     *        The viewed input and the split_view itself must outlive its iterators.
+     *
+     *        for (std::string_view field : strutil::split_view(line, '\t')) { ... }
+     */
+    class split_view
+    {
+    public:
+        /**
+         * @brief Forward iterator yielding the tokens of a split_view.
+         */
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const std::string_view *;
+            using reference         = const std::string_view &;
+
+            iterator() = default;
+
+            reference operator*()  const { return token_; }
+            pointer   operator->() const { return &token_; }
+
+            iterator & operator++()
+            {
+                do
+                {
+                    advance();
+                } while (owner_ && !owner_->keep_empty_ && token_.empty());
+
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator & lhs, const iterator & rhs)
+            {
+                return lhs.owner_ == rhs.owner_ && lhs.pos_ == rhs.pos_;
+            }
+
+            friend bool operator!=(const iterator & lhs, const iterator & rhs)
+            {
+                return !(lhs == rhs);
+            }
+
+        private:
+            friend class split_view;
+
+            explicit iterator(const split_view * owner) : owner_(owner)
+            {
+                token_ = owner_->str_.substr(0, owner_->find_delim(0));
+                if (!owner_->keep_empty_ && token_.empty())
+                {
+                    ++*this;
+                }
+            }
+
+            void advance()
+            {
+                const size_t token_end = pos_ + token_.size();
+                if (token_end == owner_->str_.size())
+                {
+                    // The last token has been consumed: become the end iterator.
+                    *this = iterator();
+                    return;
+                }
+
+                pos_   = token_end + owner_->delim_length();
+                token_ = owner_->str_.substr(pos_, owner_->find_delim(pos_) - pos_);
+            }
+
+            const split_view * owner_ = nullptr;
+            size_t             pos_   = 0;
+            std::string_view   token_;
+        };
+
+        /**
+         * @brief Creates a lazy split of str on a single character.
+         * @param str - std::string_view that will be split.
+         * @param delim - the delimiter.
+         * @param keep_empty - if true (default), empty tokens are yielded;
+         *                     if false, empty tokens are skipped.
+         */
+        split_view(std::string_view str, char delim, bool keep_empty = true)
+            : str_(str), delim_char_(delim), mode_(mode::character), keep_empty_(keep_empty)
+        {
+        }
+
+        /**
+         * @brief Creates a lazy split of str on a delimiter string.
+         *        An empty delim never matches, so the whole str is one token.
+         * @param str - std::string_view that will be split.
+         * @param delim - the delimiter; the viewed memory must outlive the split_view.
+         * @param keep_empty - if true (default), empty tokens are yielded;
+         *                     if false, empty tokens are skipped.
+         */
+        split_view(std::string_view str, std::string_view delim, bool keep_empty = true)
+            : str_(str), delim_(delim), mode_(mode::string), keep_empty_(keep_empty)
+        {
+        }
+
+        iterator begin() const { return iterator(this); }
+        iterator end()   const { return iterator(); }
+
+    private:
+        friend split_view split_any_view(std::string_view, const char_set &, bool);
+
+        enum class mode { character, string, any };
+
+        split_view(std::string_view str, const char_set & delims, bool keep_empty)
+            : str_(str), delim_set_(delims), mode_(mode::any), keep_empty_(keep_empty)
+        {
+        }
+
+        // Position of the next delimiter at or after pos, or str_.size() if there is none.
+        size_t find_delim(size_t pos) const
+        {
+            size_t found = std::string_view::npos;
+            switch (mode_)
+            {
+                case mode::character: found = detail::find_char(str_, delim_char_, pos);      break;
+                case mode::string:    if (!delim_.empty()) found = str_.find(delim_, pos); break;
+                case mode::any:       found = find_first_of(str_, delim_set_, pos);      break;
+            }
+
+            return found == std::string_view::npos ? str_.size() : found;
+        }
+
+        size_t delim_length() const
+        {
+            return mode_ == mode::string ? delim_.size() : 1;
+        }
+
+        std::string_view str_;
+        std::string_view delim_;
+        char_set         delim_set_;
+        char             delim_char_ = '\0';
+        mode             mode_;
+        bool             keep_empty_;
+    };
+
+    /**
+     * @brief Creates a lazy split_view of str on any character of the delimiter set,
+     *        the lazy counterpart of split_any.
+     * @param str - std::string_view that will be split.
+     * @param delims - the delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are yielded;
+     *                     if false, empty tokens are skipped.
+     * @return split_view yielding the tokens of str.
+     */
+    inline split_view split_any_view(std::string_view str, const char_set & delims, bool keep_empty = true)
+    {
+        return split_view(str, delims, keep_empty);
+    }
+
+    /**
+     * @brief Creates a lazy split_view of str on any character of the delimiter set,
+     *        the lazy counterpart of split_any.
+     * @param str - std::string_view that will be split.
+     * @param delims - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are yielded;
+     *                     if false, empty tokens are skipped.
+     * @return split_view yielding the tokens of str.
+     */
+    inline split_view split_any_view(std::string_view str, std::string_view delims, bool keep_empty = true)
+    {
+        return split_any_view(str, char_set(delims), keep_empty);
     }
 
     /**
-      * @brief Trims white spaces from the both sides of std::string.
-      *        Taken from: http://stackoverflow.com/questions/216823/whats-the-best-way-to-trim-stdstring.
-      * @param str - input std::string to remove white spaces from.
-      * @return Copy of input str with trimmed white spaces.
-      */
-    inline std::string trim_copy(std::string str)
+     * @brief What parse_kv does with keys that occur more than once.
+     */
+    enum class duplicate_keys
     {
-        trim(str);
-        return str;
+        keep_all,   //!< Every pair is returned.
+        keep_first, //!< Only the first pair with a given key is returned.
+        keep_last   //!< Only the last pair with a given key is returned.
+    };
+
+    namespace detail
+    {
+        // Splits one pair at its first kv_delim; a pair without one is all key.
+        // Blank pairs (empty, or only white space when trimming) yield nothing.
+        inline std::optional<std::pair<std::string_view, std::string_view>> parse_kv_pair(std::string_view pair, char kv_delim, bool trim)
+        {
+            if (trim)
+            {
+                pair = trim_view(pair);
+            }
+            if (pair.empty())
+            {
+                return std::nullopt;
+            }
+
+            const size_t at = find_char(pair, kv_delim, 0);
+            if (at == std::string_view::npos)
+            {
+                return std::make_pair(pair, std::string_view());
+            }
+
+            std::string_view key   = pair.substr(0, at);
+            std::string_view value = pair.substr(at + 1);
+            return trim ? std::make_pair(trim_right_view(key), trim_left_view(value)) : std::make_pair(key, value);
+        }
     }
 
     /**
-     * @brief Replaces (in-place) the first occurrence of target with replacement.
-     *        Taken from: http://stackoverflow.com/questions/3418231/c-replace-part-of-a-string-with-another-string.
-     * @param str - input std::string that will be modified.
-     * @param target - substring that will be replaced with replacement.
-     * @param replacement - substring that will replace target.
-     * @return True if replacement was successfull, false otherwise.
+     * @brief Parses key/value pairs such as "k=v;k2=v2" or a query string
+     *        without copying: keys and values are views into the memory viewed
+     *        by str, which must outlive the result. Pairs are split at their
+     *        first kv_delim; a pair without one has an empty value. Empty
+     *        pairs are skipped. Values are returned as they are, with no
+     *        unescaping.
+     * @param str - text that will be parsed.
+     * @param pair_delim - delimiter between pairs, e.g. ';' or '&'.
+     * @param kv_delim - delimiter between key and value, e.g. '='.
+     * @param trim - if true, white spaces around pairs, keys and values are
+     *               trimmed as trim does; default false.
+     * @param duplicates - which pairs to keep for repeated keys; default all.
+     * @return (key, value) pairs in input order.
      */
-    inline bool replace_first(std::string & str, const std::string & target, const std::string & replacement)
+    inline std::vector<std::pair<std::string_view, std::string_view>> parse_kv(std::string_view str, char pair_delim, char kv_delim,
+                                                                                bool trim = false,
+                                                                                duplicate_keys duplicates = duplicate_keys::keep_all)
     {
-        if (target.empty())
+        std::vector<std::pair<std::string_view, std::string_view>> pairs;
+        pairs.reserve(detail::count_char(str.data(), str.data() + str.size(), pair_delim) + 1);
+        for (size_t pos = 0; pos <= str.size();)
         {
-            return false;
+            const size_t found = detail::find_char(str, pair_delim, pos);
+            const size_t end   = found == std::string_view::npos ? str.size() : found;
+            if (const auto pair = detail::parse_kv_pair(str.substr(pos, end - pos), kv_delim, trim))
+            {
+                pairs.push_back(*pair);
+            }
+            pos = end + 1;
         }
-        
-        const size_t start_pos = str.find(target);
-        if (start_pos == std::string::npos)
+
+        if (duplicates == duplicate_keys::keep_all)
         {
-            return false;
+            return pairs;
         }
 
-        str.replace(start_pos, target.length(), replacement);
-        return true;
+        // Mark the survivors, walking backwards to find the last occurrences,
+        // then compact them in input order.
+        std::vector<bool>                    keep(pairs.size());
+        std::unordered_set<std::string_view> seen;
+        seen.reserve(pairs.size());
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            const size_t at = duplicates == duplicate_keys::keep_first ? i : pairs.size() - 1 - i;
+            keep[at]        = seen.insert(pairs[at].first).second;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            if (keep[i])
+            {
+                pairs[kept++] = pairs[i];
+            }
+        }
+        pairs.resize(kept);
+        return pairs;
     }
 
     /**
-     * @brief Replaces (in-place) last occurrence of target with replacement.
-     *        Taken from: http://stackoverflow.com/questions/3418231/c-replace-part-of-a-string-with-another-string.
-     * @param str - input std::string that will be modified.
-     * @param target - substring that will be replaced with replacement.
-     * @param replacement - substring that will replace target.
-     * @return True if replacement was successfull, false otherwise.
+     * @brief Lazy counterpart of parse_kv: a range yielding (key, value) views
+     *        one pair at a time, without heap allocation. All pairs are
+     *        yielded, duplicates included. The viewed input and the kv_view
+     *        itself must outlive its iterators.
+     *
+     *        for (auto [key, value] : strutil::kv_view(query, '&', '=')) { ... }
      */
-    inline bool replace_last(std::string & str, const std::string & target, const std::string & replacement)
+    class kv_view
     {
-        if (target.empty())
+    public:
+        /**
+         * @brief Forward iterator yielding the pairs of a kv_view.
+         */
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::pair<std::string_view, std::string_view>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const value_type *;
+            using reference         = const value_type &;
+
+            iterator() = default;
+
+            reference operator*()  const { return pair_; }
+            pointer   operator->() const { return &pair_; }
+
+            iterator & operator++()
+            {
+                ++pairs_;
+                settle();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator==(const iterator & lhs, const iterator & rhs)
+            {
+                return lhs.pairs_ == rhs.pairs_;
+            }
+
+            friend bool operator!=(const iterator & lhs, const iterator & rhs)
+            {
+                return !(lhs == rhs);
+            }
+
+        private:
+            friend class kv_view;
+
+            iterator(const kv_view * owner, split_view::iterator pairs) : owner_(owner), pairs_(pairs)
+            {
+                settle();
+            }
+
+            // Moves to the first non-blank pair at or after the current one.
+            void settle()
+            {
+                for (; pairs_ != owner_->pairs_.end(); ++pairs_)
+                {
+                    if (const auto pair = detail::parse_kv_pair(*pairs_, owner_->kv_delim_, owner_->trim_))
+                    {
+                        pair_ = *pair;
+                        return;
+                    }
+                }
+            }
+
+            const kv_view *      owner_ = nullptr;
+            split_view::iterator pairs_;
+            value_type           pair_;
+        };
+
+        /**
+         * @brief Creates a lazy parse of str, with the same arguments as parse_kv.
+         * @param str - text that will be parsed.
+         * @param pair_delim - delimiter between pairs.
+         * @param kv_delim - delimiter between key and value.
+         * @param trim - if true, white spaces around pairs, keys and values are trimmed.
+         */
+        kv_view(std::string_view str, char pair_delim, char kv_delim, bool trim = false)
+            : pairs_(str, pair_delim, false), kv_delim_(kv_delim), trim_(trim)
         {
-            return false;
         }
 
-        size_t start_pos = str.rfind(target);
-        if (start_pos == std::string::npos)
+        iterator begin() const { return iterator(this, pairs_.begin()); }
+        iterator end()   const { return iterator(this, pairs_.end()); }
+
+    private:
+        split_view pairs_;
+        char       kv_delim_;
+        bool       trim_;
+    };
+
+    /**
+     * @brief Compact container of strings: all characters live in one
+     *        contiguous buffer and each string is a pair of neighbouring
+     *        offsets, so n strings cost one allocation for the text and
+     *        n + 1 offsets instead of n separate std::string objects. Elements
+     *        are read as std::string_view; the views stay valid until the
+     *        table is modified. Filled by append_split, append_split_any and
+     *        append_regex_split; join, drop_empty, drop_duplicate and the
+     *        sorting functions accept it like a std::vector<std::string>.
+     */
+    class string_table
+    {
+    public:
+        /**
+         * @brief Random access iterator yielding the strings as std::string_view.
+         */
+        class iterator
         {
-            return false;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = void;
+            using reference         = std::string_view;
+
+            iterator() = default;
+
+            reference operator*() const { return (*table_)[index_]; }
+            reference operator[](difference_type n) const { return (*table_)[index_ + static_cast<size_t>(n)]; }
+
+            iterator & operator++() { ++index_; return *this; }
+            iterator & operator--() { --index_; return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++index_; return tmp; }
+            iterator operator--(int) { iterator tmp = *this; --index_; return tmp; }
+
+            iterator & operator+=(difference_type n) { index_ += static_cast<size_t>(n); return *this; }
+            iterator & operator-=(difference_type n) { index_ -= static_cast<size_t>(n); return *this; }
+
+            friend iterator operator+(iterator it, difference_type n) { return it += n; }
+            friend iterator operator+(difference_type n, iterator it) { return it += n; }
+            friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+
+            friend difference_type operator-(const iterator & lhs, const iterator & rhs)
+            {
+                return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+            }
+
+            friend bool operator==(const iterator & lhs, const iterator & rhs) { return lhs.index_ == rhs.index_; }
+            friend bool operator!=(const iterator & lhs, const iterator & rhs) { return lhs.index_ != rhs.index_; }
+            friend bool operator<(const iterator & lhs, const iterator & rhs)  { return lhs.index_ < rhs.index_; }
+            friend bool operator>(const iterator & lhs, const iterator & rhs)  { return lhs.index_ > rhs.index_; }
+            friend bool operator<=(const iterator & lhs, const iterator & rhs) { return lhs.index_ <= rhs.index_; }
+            friend bool operator>=(const iterator & lhs, const iterator & rhs) { return lhs.index_ >= rhs.index_; }
+
+        private:
+            friend class string_table;
+
+            iterator(const string_table * table, size_t index) : table_(table), index_(index)
+            {
+            }
+
+            const string_table * table_ = nullptr;
+            size_t               index_ = 0;
+        };
+
+        using value_type     = std::string_view;
+        using size_type      = size_t;
+        using const_iterator = iterator;
+
+        string_table() = default;
+
+        /**
+         * @brief Creates a table holding copies of the strings in [first, last).
+         */
+        template<typename InputIt>
+        string_table(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                push_back(std::string_view(*first));
+            }
         }
 
-        str.replace(start_pos, target.length(), replacement);
-        return true;
-    }
+        //! Number of strings.
+        size_t size() const { return offsets_.size() - 1; }
+
+        bool empty() const { return size() == 0; }
+
+        //! Total number of characters of all strings.
+        size_t chars() const { return blob_.size(); }
+
+        std::string_view operator[](size_t index) const
+        {
+            return std::string_view(blob_.data() + offsets_[index], offsets_[index + 1] - offsets_[index]);
+        }
+
+        std::string_view front() const { return (*this)[0]; }
+        std::string_view back()  const { return (*this)[size() - 1]; }
+
+        iterator begin() const { return iterator(this, 0); }
+        iterator end()   const { return iterator(this, size()); }
+
+        //! Appends a copy of str.
+        void push_back(std::string_view str)
+        {
+            blob_.append(str);
+            offsets_.push_back(blob_.size());
+        }
+
+        //! Reserves room for strings more strings totalling chars more characters.
+        //! Capacity grows at least geometrically, so repeated calls stay amortized O(1).
+        void reserve(size_t strings, size_t chars)
+        {
+            if (offsets_.size() + strings > offsets_.capacity())
+            {
+                offsets_.reserve(std::max(offsets_.size() + strings, 2 * offsets_.capacity()));
+            }
+            if (blob_.size() + chars > blob_.capacity())
+            {
+                blob_.reserve(std::max(blob_.size() + chars, 2 * blob_.capacity()));
+            }
+        }
+
+        void clear()
+        {
+            blob_.clear();
+            offsets_.assign(1, 0);
+        }
+
+        //! Replaces the contents with copies of the strings in [first, last), which may view this table.
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last)
+        {
+            string_table copy(first, last);
+            swap(copy);
+        }
+
+        void swap(string_table & other) noexcept
+        {
+            blob_.swap(other.blob_);
+            offsets_.swap(other.offsets_);
+        }
+
+        friend bool operator==(const string_table & lhs, const string_table & rhs)
+        {
+            return lhs.offsets_ == rhs.offsets_ && lhs.blob_ == rhs.blob_;
+        }
+
+        friend bool operator!=(const string_table & lhs, const string_table & rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend void drop_empty(string_table & tokens);
+
+        std::string         blob_;
+        std::vector<size_t> offsets_ = std::vector<size_t>(1, 0);
+    };
 
     /**
-     * @brief Replaces (in-place) all occurrences of target with replacement.
-     *        Taken from: http://stackoverflow.com/questions/3418231/c-replace-part-of-a-string-with-another-string.
-     * @param str - input std::string that will be modified.
-     * @param target - substring that will be replaced with replacement.
-     * @param replacement - substring that will replace target.
-     * @return True if replacement was successfull, false otherwise.
+     * @brief Splits input std::string_view str according to input char delim,
+     *        appending the tokens to table. Token semantics match split.
+     * @param table - string_table the tokens are appended to.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
      */
-    inline bool replace_all(std::string & str, const std::string & target, const std::string & replacement)
+    inline void append_split(string_table & table, std::string_view str, char delim, bool keep_empty = true)
     {
-        if (target.empty())
+        table.reserve(detail::count_char(str.data(), str.data() + str.size(), delim) + 1, str.size());
+        for (const std::string_view token : split_view(str, delim, keep_empty))
         {
-            return false;
+            table.push_back(token);
         }
+    }
 
-        bool replaced = false;
-        size_t start_pos = 0;
-        while ((start_pos = str.find(target, start_pos)) != std::string::npos)
+    /**
+     * @brief Splits input std::string_view str according to input delimiter string,
+     *        appending the tokens to table. Token semantics match split.
+     * @param table - string_table the tokens are appended to.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     */
+    inline void append_split(string_table & table, std::string_view str, std::string_view delim, bool keep_empty = true)
+    {
+        table.reserve(0, str.size());
+        for (const std::string_view token : split_view(str, delim, keep_empty))
         {
-            str.replace(start_pos, target.length(), replacement);
-            start_pos += replacement.length();
-            replaced = true;
+            table.push_back(token);
         }
+    }
 
-        return replaced;
+    /**
+     * @brief Splits input std::string_view str using any delimiter in the given set,
+     *        appending the tokens to table. Token semantics match split_any.
+     * @param table - string_table the tokens are appended to.
+     * @param str - std::string_view that will be split.
+     * @param delims - the delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     */
+    inline void append_split_any(string_table & table, std::string_view str, const char_set & delims, bool keep_empty = true)
+    {
+        table.reserve(0, str.size());
+        for (const std::string_view token : split_any_view(str, delims, keep_empty))
+        {
+            table.push_back(token);
+        }
     }
 
     /**
-     * @brief Checks if std::string str ends with specified suffix.
-     * @param str - input std::string that will be checked.
-     * @param suffix - searched suffix in str.
-     * @return True if suffix was found, false otherwise.
+     * @brief Splits input std::string_view str using any delimiter in the given set,
+     *        appending the tokens to table. Token semantics match split_any.
+     * @param table - string_table the tokens are appended to.
+     * @param str - std::string_view that will be split.
+     * @param delims - the set of delimiter characters.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
      */
-    inline bool ends_with(const std::string & str, const std::string & suffix)
+    inline void append_split_any(string_table & table, std::string_view str, std::string_view delims, bool keep_empty = true)
     {
-        return suffix.size() <= str.size() &&
-               str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+        append_split_any(table, str, char_set(delims), keep_empty);
     }
 
     /**
-     * @brief Checks if std::string str ends with specified character.
-     * @param str - input std::string that will be checked.
-     * @param suffix - searched character in str.
-     * @return True if ends with character, false otherwise.
+     * @brief Splits input string using regex as a delimiter, appending the
+     *        tokens to table. Token semantics match regex_split.
+     * @param table - string_table the tokens are appended to.
+     * @param src - std::string_view that will be split.
+     * @param rgx - the delimiter regex.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
      */
-    inline bool ends_with(const std::string & str, const char suffix)
+    inline void append_regex_split(string_table & table, std::string_view src, const std::regex & rgx, bool keep_empty = true)
     {
-        return !str.empty() && (str.back() == suffix);
+        table.reserve(0, src.size());
+        std::cregex_token_iterator iter(src.data(), src.data() + src.size(), rgx, -1);
+        const std::cregex_token_iterator end;
+        for (; iter != end; ++iter)
+        {
+            if (keep_empty || iter->length() != 0)
+            {
+                table.push_back(std::string_view(iter->first, static_cast<size_t>(iter->length())));
+            }
+        }
     }
 
     /**
-     * @brief Checks if std::string str starts with specified prefix.
-     * @param str - input std::string that will be checked.
-     * @param prefix - searched prefix in str.
-     * @return True if prefix was found, false otherwise.
+     * @brief Splits input string using a dfa_regex as a delimiter, appending
+     *        the tokens to table. Token semantics match regex_split.
+     * @param table - string_table the tokens are appended to.
+     * @param src - std::string_view that will be split.
+     * @param rgx - the delimiter regex.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
      */
-    inline bool starts_with(const std::string & str, const std::string & prefix)
+    inline void append_regex_split(string_table & table, std::string_view src, const dfa_regex & rgx, bool keep_empty = true)
     {
-        return str.rfind(prefix, 0) == 0;
+        table.reserve(0, src.size());
+        const auto pairs = regex_split_pairs(src, rgx);
+        const std::string_view first = pairs.empty() ? src : src.substr(0, static_cast<size_t>(pairs.front().first.data() - src.data()));
+        if (keep_empty || !first.empty())
+        {
+            table.push_back(first);
+        }
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            // The remainder after the last delimiter is dropped when empty, as in regex_split.
+            const std::string_view token = pairs[i].second;
+            if ((keep_empty && i + 1 < pairs.size()) || !token.empty())
+            {
+                table.push_back(token);
+            }
+        }
     }
 
-    /**
-     * @brief Checks if std::string str starts with specified character.
-     * @param str - input std::string that will be checked.
-     * @param prefix - searched character in str.
-     * @return True if starts with character, false otherwise.
-     */
-    inline bool starts_with(const std::string & str, const char prefix)
-    {
-        return !str.empty() && (str.front() == prefix);
+    namespace detail
+    {
+        // 64-bit hash of a byte string: 8-byte words folded in with a
+        // multiply-xorshift step, then a final avalanche. Much cheaper than
+        // std::hash on short tokens and good enough for open addressing.
+        inline uint64_t hash_string(std::string_view str)
+        {
+            constexpr uint64_t mul = 0x9E3779B97F4A7C15ull;
+            const char * data      = str.data();
+            size_t       n         = str.size();
+            uint64_t     hash      = (n + 1) * mul;
+            for (; n >= 8; data += 8, n -= 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, data, 8);
+                hash = (hash ^ word) * mul;
+                hash ^= hash >> 29;
+            }
+            if (n != 0)
+            {
+                uint64_t word = 0;
+                std::memcpy(&word, data, n);
+                hash = (hash ^ word) * mul;
+                hash ^= hash >> 29;
+            }
+            hash *= 0xD6E8FEB86659FD93ull;
+            return hash ^ (hash >> 32);
+        }
+
+        // Open-addressing (linear probing) index of uint32_t ids by hash. It
+        // stores only the low 32 bits of each hash next to the id, 8 bytes a
+        // slot; the caller owns the keys and compares them in find. Kept at
+        // most half full.
+        class string_index
+        {
+        public:
+            static constexpr uint32_t npos = 0xFFFFFFFFu;
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            void reserve(size_t count)
+            {
+                size_t capacity = 16;
+                while (capacity < count * 2)
+                {
+                    capacity *= 2;
+                }
+                if (capacity > slots_.size())
+                {
+                    rehash(capacity);
+                }
+            }
+
+            // Returns the id whose key equals the probed one (is_key(id) is
+            // true), or npos.
+            template<typename IsKey>
+            uint32_t find(uint64_t hash, IsKey is_key) const
+            {
+                if (slots_.empty())
+                {
+                    return npos;
+                }
+                const uint32_t tag  = static_cast<uint32_t>(hash);
+                const size_t   mask = slots_.size() - 1;
+                for (size_t i = tag & mask; slots_[i].id != npos; i = (i + 1) & mask)
+                {
+                    if (slots_[i].tag == tag && is_key(slots_[i].id))
+                    {
+                        return slots_[i].id;
+                    }
+                }
+                return npos;
+            }
+
+            // Adds id under hash; its key must not be in the index yet.
+            void insert(uint64_t hash, uint32_t id)
+            {
+                if ((size_ + 1) * 2 > slots_.size())
+                {
+                    rehash(std::max<size_t>(slots_.size() * 2, 16));
+                }
+                place(static_cast<uint32_t>(hash), id);
+                ++size_;
+            }
+
+        private:
+            struct slot
+            {
+                uint32_t tag = 0;
+                uint32_t id  = npos;
+            };
+
+            void place(uint32_t tag, uint32_t id)
+            {
+                const size_t mask = slots_.size() - 1;
+                size_t       i    = tag & mask;
+                while (slots_[i].id != npos)
+                {
+                    i = (i + 1) & mask;
+                }
+                slots_[i] = slot { tag, id };
+            }
+
+            void rehash(size_t capacity)
+            {
+                std::vector<slot> old(capacity);
+                old.swap(slots_);
+                for (const slot & s : old)
+                {
+                    if (s.id != npos)
+                    {
+                        place(s.tag, s.id);
+                    }
+                }
+            }
+
+            std::vector<slot> slots_;
+            size_t            size_ = 0;
+        };
     }
 
     /**
-     * @brief Splits input std::string str according to input delim.
-     * @param str - std::string that will be splitted.
-     * @param delim - the delimiter.
-     * @param keep_empty - if true (default), empty tokens are kept in the result;
-     *                     if false, empty tokens are skipped.
-     * @return std::vector<std::string> that contains all splitted tokens.
+     * @brief Thread-safe string interning pool. Each distinct string is copied
+     *        once into an arena owned by the pool and identified by a stable
+     *        std::string_view and a 32-bit id, both valid for the lifetime of
+     *        the pool. Strings are spread over independently locked shards by
+     *        hash, so threads interning concurrently rarely contend, and
+     *        interning a string already in the pool only takes a shared lock.
      */
-    inline std::vector<std::string> split(const std::string & str, const char delim, bool keep_empty = true)
+    class intern_pool
     {
-        std::vector<std::string> tokens;
-        std::stringstream ss(str);
+    public:
+        using id_type = uint32_t;
 
-        std::string token;
-        while(std::getline(ss, token, delim))
+        /**
+         * @param shards - number of independently locked shards, rounded up
+         *                 to a power of two between 1 and 256.
+         */
+        explicit intern_pool(size_t shards = 16)
         {
-            if (keep_empty || !token.empty())
+            while ((size_t(1) << shard_bits_) < std::min<size_t>(shards, 256))
             {
-                tokens.push_back(token);
+                ++shard_bits_;
             }
+            shards_.reset(new shard[size_t(1) << shard_bits_]);
         }
 
-        // Match semantics of split(str,str): preserve trailing empty token only when keeping empties.
-        if (keep_empty && (str.empty() || ends_with(str, delim)))
+        intern_pool(const intern_pool &) = delete;
+        intern_pool & operator=(const intern_pool &) = delete;
+
+        /**
+         * @brief Interns str, copying it into the pool unless an equal string is already there.
+         * @return The pooled copy of str.
+         */
+        std::string_view intern(std::string_view str)
         {
-            tokens.emplace_back();
+            return insert(str).second;
         }
 
-        return tokens;
-    }
+        /**
+         * @brief Interns str, copying it into the pool unless an equal string is already there.
+         * @return Id of the pooled copy of str.
+         */
+        id_type intern_id(std::string_view str)
+        {
+            return insert(str).first;
+        }
 
-    /**
-     * @brief Splits input std::string str according to input std::string delim.
-     *        Taken from: https://stackoverflow.com/a/46931770/1892346.
-     * @param str - std::string that will be split.
-     * @param delim - the delimiter.
-     * @param keep_empty - if true (default), empty tokens are kept in the result;
-     *                     if false, empty tokens are skipped.
-     * @return std::vector<std::string> that contains all splitted tokens.
-     */
-    inline std::vector<std::string> split(const std::string & str, const std::string & delim, bool keep_empty = true)
-    {
-        size_t pos_start = 0, pos_end, delim_len = delim.length();
-        std::string token;
-        std::vector<std::string> tokens;
+        /**
+         * @brief Looks str up without interning it.
+         * @return Id of the pooled copy of str, or std::nullopt if str was never interned.
+         */
+        std::optional<id_type> find(std::string_view str) const
+        {
+            const uint64_t hash = detail::hash_string(str);
+            const size_t   at   = shard_index(hash);
+            std::shared_lock<std::shared_mutex> lock(shards_[at].mutex);
+            const uint32_t local = shards_[at].find(str, hash);
+            if (local == detail::string_index::npos)
+            {
+                return std::nullopt;
+            }
+            return make_id(local, at);
+        }
+
+        //! The pooled string with the given id, which must come from this pool.
+        std::string_view operator[](id_type id) const
+        {
+            const shard & s = shards_[id & ((id_type(1) << shard_bits_) - 1)];
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            return s.strings[id >> shard_bits_];
+        }
+
+        //! Number of distinct strings in the pool.
+        size_t size() const
+        {
+            size_t count = 0;
+            for (size_t i = 0; i < (size_t(1) << shard_bits_); ++i)
+            {
+                std::shared_lock<std::shared_mutex> lock(shards_[i].mutex);
+                count += shards_[i].strings.size();
+            }
+            return count;
+        }
+
+    private:
+        // Strings longer than this get an allocation of their own.
+        static constexpr size_t chunk_size = 64 * 1024;
+
+        struct alignas(64) shard
+        {
+            mutable std::shared_mutex              mutex;
+            detail::string_index                   index;
+            std::vector<std::string_view>          strings;
+            std::vector<std::unique_ptr<char[]>>   chunks;
+            char *                                 cursor    = nullptr;
+            size_t                                 remaining = 0;
+
+            uint32_t find(std::string_view str, uint64_t hash) const
+            {
+                return index.find(hash, [&](uint32_t local) { return strings[local] == str; });
+            }
+
+            std::string_view store(std::string_view str)
+            {
+                if (str.empty())
+                {
+                    return std::string_view();
+                }
+                if (str.size() > chunk_size / 4)
+                {
+                    chunks.emplace_back(new char[str.size()]);
+                    std::memcpy(chunks.back().get(), str.data(), str.size());
+                    return std::string_view(chunks.back().get(), str.size());
+                }
+                if (str.size() > remaining)
+                {
+                    chunks.emplace_back(new char[chunk_size]);
+                    cursor    = chunks.back().get();
+                    remaining = chunk_size;
+                }
+                std::memcpy(cursor, str.data(), str.size());
+                const std::string_view stored(cursor, str.size());
+                cursor += str.size();
+                remaining -= str.size();
+                return stored;
+            }
+        };
+
+        size_t shard_index(uint64_t hash) const
+        {
+            // The index probes with the low bits; pick the shard from the high ones.
+            return static_cast<size_t>((hash >> 56) & ((uint64_t(1) << shard_bits_) - 1));
+        }
+
+        id_type make_id(uint32_t local, size_t at) const
+        {
+            return (local << shard_bits_) | static_cast<id_type>(at);
+        }
 
-        while ((pos_end = str.find(delim, pos_start)) != std::string::npos)
+        std::pair<id_type, std::string_view> insert(std::string_view str)
         {
-            token = str.substr(pos_start, pos_end - pos_start);
-            pos_start = pos_end + delim_len;
-            if (keep_empty || !token.empty())
+            const uint64_t hash = detail::hash_string(str);
+            const size_t   at   = shard_index(hash);
+            shard &        s    = shards_[at];
+            {
+                std::shared_lock<std::shared_mutex> lock(s.mutex);
+                const uint32_t local = s.find(str, hash);
+                if (local != detail::string_index::npos)
+                {
+                    return { make_id(local, at), s.strings[local] };
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> lock(s.mutex);
+            uint32_t local = s.find(str, hash);
+            if (local == detail::string_index::npos)
             {
-                tokens.push_back(token);
+                if (s.strings.size() >= (size_t(1) << (32 - shard_bits_)) - 1)
+                {
+                    throw std::length_error("strutil::intern_pool: too many strings in one shard");
+                }
+                local = static_cast<uint32_t>(s.strings.size());
+                // Grow up front so nothing below throws once the string is stored.
+                if (s.strings.size() == s.strings.capacity())
+                {
+                    s.strings.reserve(std::max<size_t>(2 * s.strings.capacity(), 16));
+                }
+                s.index.reserve(s.strings.size() + 1);
+                s.strings.push_back(s.store(str));
+                s.index.insert(hash, local);
             }
+            return { make_id(local, at), s.strings[local] };
         }
 
-        token = str.substr(pos_start);
-        if (keep_empty || !token.empty())
+        unsigned                 shard_bits_ = 0;
+        std::unique_ptr<shard[]> shards_;
+    };
+
+    /**
+     * @brief Splits input std::string_view str according to input char delim,
+     *        interning each token in pool. Token semantics match split.
+     * @param pool - intern_pool the tokens are interned in.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector<std::string_view> of the pooled tokens, valid as long as pool.
+     */
+    inline std::vector<std::string_view> split_interned(intern_pool & pool, std::string_view str, char delim, bool keep_empty = true)
+    {
+        std::vector<std::string_view> tokens;
+        tokens.reserve(detail::count_char(str.data(), str.data() + str.size(), delim) + 1);
+        for (const std::string_view token : split_view(str, delim, keep_empty))
         {
-            tokens.push_back(token);
+            tokens.push_back(pool.intern(token));
         }
         return tokens;
     }
 
     /**
-     * @brief Splits input string using regex as a delimiter.
-     * @param src - std::string that will be split.
-     * @param rgx_str - the set of delimiter characters.
+     * @brief Splits input std::string_view str according to input delimiter string,
+     *        interning each token in pool. Token semantics match split.
+     * @param pool - intern_pool the tokens are interned in.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
      * @param keep_empty - if true (default), empty tokens are kept in the result;
      *                     if false, empty tokens are skipped.
-     * @return vector of resulting tokens.
+     * @return std::vector<std::string_view> of the pooled tokens, valid as long as pool.
      */
-    inline std::vector<std::string> regex_split(const std::string& src, const std::string& rgx_str, bool keep_empty = true)
+    inline std::vector<std::string_view> split_interned(intern_pool & pool, std::string_view str, std::string_view delim, bool keep_empty = true)
     {
-        std::vector<std::string> elems;
-        const std::regex rgx(rgx_str);
-        std::sregex_token_iterator iter(src.begin(), src.end(), rgx, -1);
-        std::sregex_token_iterator end;
-        while (iter != end)
+        std::vector<std::string_view> tokens;
+        for (const std::string_view token : split_view(str, delim, keep_empty))
         {
-            if (keep_empty || iter->length() != 0)
-            {
-                elems.push_back(*iter);
-            }
-            ++iter;
+            tokens.push_back(pool.intern(token));
         }
-        return elems;
+        return tokens;
     }
 
     /**
-     * @brief Splits input string using regex as a delimiter.
-     * @param src - std::string that will be split.
-     * @param dest - map of matched delimiter and those being splitted.
-     * @param rgx_str - the set of delimiter characters.
-     * @return True if the parsing is successfully done.
+     * @brief Splits input std::string_view str according to input char delim,
+     *        interning each token in pool. Token semantics match split.
+     * @param pool - intern_pool the tokens are interned in.
+     * @param str - std::string_view that will be split.
+     * @param delim - the delimiter.
+     * @param keep_empty - if true (default), empty tokens are kept in the result;
+     *                     if false, empty tokens are skipped.
+     * @return std::vector of the pool ids of the tokens.
      */
-    inline std::map<std::string, std::string> regex_split_map(const std::string& src, const std::string& rgx_str)
+    inline std::vector<intern_pool::id_type> split_interned_ids(intern_pool & pool, std::string_view str, char delim, bool keep_empty = true)
     {
-        std::map<std::string, std::string> dest;
-        std::string tstr = src + " ";
-        std::regex rgx(rgx_str);
-        std::sregex_token_iterator niter(tstr.begin(), tstr.end(), rgx);
-        std::sregex_token_iterator viter(tstr.begin(), tstr.end(), rgx, -1);
-        std::sregex_token_iterator end;
-        ++viter;
-        while (niter != end)
+        std::vector<intern_pool::id_type> ids;
+        ids.reserve(detail::count_char(str.data(), str.data() + str.size(), delim) + 1);
+        for (const std::string_view token : split_view(str, delim, keep_empty))
         {
-            dest[*niter] = *viter;
-            ++niter;
-            ++viter;
+            ids.push_back(pool.intern_id(token));
         }
+        return ids;
+    }
+
+    namespace detail
+    {
+        // Elements join copies verbatim (std::string, std::string_view, const char *).
+        template<typename T>
+        constexpr bool is_string_like_v = std::is_convertible_v<const T &, std::string_view>;
 
-        return dest;
+        // Longest text format_number produces for a float or double
+        // ("-2.2250738585072014e-308"); long double uses 6 digits.
+        template<typename T>
+        constexpr size_t max_joined_number_chars = std::is_floating_point_v<T> ? 24 : max_number_chars<T>;
     }
 
     /**
-     * @brief Splits input string using any delimiter in the given set.
-     * @param str - std::string that will be split.
-     * @param delims - the set of delimiter characters.
-     * @param keep_empty - if true (default), empty tokens are kept in the result;
-     *                     if false, empty tokens are skipped.
-     * @return vector of resulting tokens.
+     * @brief Appends all elements of a container of arbitrary datatypes to
+     *        output, separated by delim, reserving the needed space once.
+     *        String-like elements are copied as they are, arithmetic elements
+     *        are formatted like to_string, other datatypes must support
+     *        << operator.
+     * @tparam Container - container type.
+     * @param output - std::string the joined elements are appended to.
+     * @param tokens - container of tokens.
+     * @param delim - the delimiter.
      */
-    inline std::vector<std::string> split_any(const std::string & str, const std::string & delims, bool keep_empty = true)
+    template<typename Container>
+    inline void append_join(std::string & output, const Container & tokens, std::string_view delim)
     {
-        std::string token;
-        std::vector<std::string> tokens;
+        using value_type = std::decay_t<decltype(*std::begin(tokens))>;
+
+        const auto first = std::begin(tokens);
+        const auto last  = std::end(tokens);
+        if (first == last)
+        {
+            return;
+        }
 
-        size_t pos_start = 0;
-        for (size_t pos_end = 0; pos_end < str.length(); ++pos_end)
+        if constexpr (detail::is_string_like_v<value_type>)
         {
-            if (contains(delims, str[pos_end]))
+            // Exact size: one reservation, then plain copies.
+            size_t count = 0;
+            size_t total = 0;
+            for (auto it = first; it != last; ++it, ++count)
             {
-                token = str.substr(pos_start, pos_end - pos_start);
-                if (keep_empty || !token.empty())
+                total += std::string_view(*it).size();
+            }
+            output.reserve(output.size() + total + (count - 1) * delim.size());
+
+            for (auto it = first; it != last; ++it)
+            {
+                if (it != first)
                 {
-                    tokens.push_back(token);
+                    output.append(delim);
                 }
-                pos_start = pos_end + 1;
+                output.append(std::string_view(*it));
             }
         }
+        else if constexpr (detail::is_parsable_number_v<value_type> || std::is_same_v<value_type, char>)
+        {
+            // Upper bound per element, then to_chars into a stack buffer.
+            constexpr size_t width = std::is_same_v<value_type, char> ? 1 : detail::max_joined_number_chars<value_type>;
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            output.reserve(output.size() + count * width + (count - 1) * delim.size());
 
-        token = str.substr(pos_start);
-        if (keep_empty || !token.empty())
+            for (auto it = first; it != last; ++it)
+            {
+                if (it != first)
+                {
+                    output.append(delim);
+                }
+                if constexpr (std::is_same_v<value_type, char>)
+                {
+                    output.push_back(*it);
+                }
+                else
+                {
+                    char buffer[detail::max_number_chars<value_type>];
+                    const auto result = detail::format_number(buffer, buffer + sizeof(buffer), *it);
+                    output.append(buffer, result.ptr);
+                }
+            }
+        }
+        else
         {
-            tokens.push_back(token);
+            std::ostringstream result;
+            for (auto it = first; it != last; ++it)
+            {
+                if (it != first)
+                {
+                    result << delim;
+                }
+
+                result << *it;
+            }
+
+            output += result.str();
         }
-        return tokens;
     }
 
     /**
      * @brief Joins all elements of a container of arbitrary datatypes
      *        into one std::string with delimiter delim.
+     *        See append_join for how elements are formatted.
      * @tparam Container - container type.
      * @param tokens - container of tokens.
      * @param delim - the delimiter.
      * @return std::string with joined elements of container tokens with delimiter delim.
      */
     template<typename Container>
-    inline std::string join(const Container & tokens, const std::string & delim)
+    inline std::string join(const Container & tokens, std::string_view delim)
     {
-        std::ostringstream result;
-        for(auto it = tokens.begin(); it != tokens.end(); ++it)
-        {
-            if(it != tokens.begin())
-            {
-                result << delim;
-            }
-
-            result << *it;
-        }
+        std::string result;
+        append_join(result, tokens, delim);
 
-        return result.str();
+        return result;
     }
 
     namespace detail
@@ -660,68 +7719,282 @@ namespace strutil
     }
 
     /**
-     * @brief Inplace removal of all empty strings in a container of strings
-     * @tparam container - container type.
-     * @param tokens - container of strings.
-     * @return container of non-empty tokens.
+     * @brief Inplace removal of all empty strings in a container of strings
+     * @tparam container - container type.
+     * @param tokens - container of strings.
+     * @return container of non-empty tokens.
+     */
+    template<template<typename, typename...> typename Container, typename... Args>
+    inline Container<std::string> drop_empty_copy(Container<std::string, Args...> tokens)
+    {
+        drop_empty(tokens);
+        return tokens;
+    }
+
+    /**
+     * @brief Inplace removal of all empty strings in a string_table,
+     *        keeping the order of the others. Empty strings own no
+     *        characters, so only offsets are removed.
+     * @param tokens - string_table of strings.
+     */
+    inline void drop_empty(string_table & tokens)
+    {
+        tokens.offsets_.erase(std::unique(tokens.offsets_.begin(), tokens.offsets_.end()), tokens.offsets_.end());
+    }
+
+    /**
+     * @brief Removal of all empty strings in a string_table.
+     * @param tokens - string_table of strings.
+     * @return string_table of non-empty tokens.
+     */
+    inline string_table drop_empty_copy(string_table tokens)
+    {
+        drop_empty(tokens);
+        return tokens;
+    }
+
+    /**
+     * @brief Inplace removal of all duplicate strings in a vector<string> where order is not to be maintained
+     *        Taken from: C++ Primer V5
+     * @tparam T - arbitrary datatype.
+     * @param tokens - vector of strings.
+     * @return vector of non-duplicate tokens.
+     */
+    template<typename T>
+    inline void drop_duplicate(std::vector<T> &tokens)
+    {
+        std::sort(tokens.begin(), tokens.end());
+        auto end_unique = std::unique(tokens.begin(), tokens.end());
+        tokens.erase(end_unique, tokens.end());
+    }
+
+    /**
+     * @brief Removal of all duplicate strings in a vector<string> where order is not to be maintained
+     *        Taken from: C++ Primer V5
+     * @tparam T - arbitrary datatype.
+     * @param tokens - vector of strings.
+     * @return vector of non-duplicate tokens.
+     */
+    template<typename T>
+    inline std::vector<T> drop_duplicate_copy(std::vector<T> tokens)
+    {
+        std::sort(tokens.begin(), tokens.end());
+        auto end_unique = std::unique(tokens.begin(), tokens.end());
+        tokens.erase(end_unique, tokens.end());
+        return tokens;
+    }
+
+    /**
+     * @brief Inplace removal of all duplicate strings in a string_table; the
+     *        remaining strings end up in ascending order, as with the vector
+     *        overload.
+     * @param tokens - string_table of strings.
+     */
+    inline void drop_duplicate(string_table & tokens)
+    {
+        std::vector<std::string_view> views(tokens.begin(), tokens.end());
+        std::sort(views.begin(), views.end());
+        views.erase(std::unique(views.begin(), views.end()), views.end());
+        tokens.assign(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Removal of all duplicate strings in a string_table.
+     * @param tokens - string_table of strings.
+     * @return string_table of non-duplicate tokens, in ascending order.
+     */
+    inline string_table drop_duplicate_copy(string_table tokens)
+    {
+        drop_duplicate(tokens);
+        return tokens;
+    }
+
+    namespace detail
+    {
+        // Hash for drop_duplicate_stable/_unordered: hash_string for string-like
+        // elements, otherwise std::hash with a final mix so that identity
+        // hashes (integers) still spread over the low bits the index probes.
+        template<typename T>
+        inline uint64_t hash_element(const T & value)
+        {
+            if constexpr (std::is_convertible_v<const T &, std::string_view>)
+            {
+                return hash_string(std::string_view(value));
+            }
+            else
+            {
+                const uint64_t hash = static_cast<uint64_t>(std::hash<T>{}(value)) * 0x9E3779B97F4A7C15ull;
+                return hash ^ (hash >> 32);
+            }
+        }
+
+        // Single pass over tokens that keeps the first occurrence of each
+        // value. Kept elements are indexed by position, which is only ever
+        // written before the scan passes it. stable compacts the kept prefix;
+        // otherwise each duplicate is overwritten by the last unscanned
+        // element, moving one element per duplicate instead of shifting all.
+        template<typename T>
+        inline void drop_duplicate_hashed(std::vector<T> & tokens, bool stable)
+        {
+            if (tokens.size() >= string_index::npos)
+            {
+                throw std::length_error("strutil::drop_duplicate: too many elements to index");
+            }
+            string_index index;
+            size_t       kept = 0;
+            size_t       last = tokens.size();
+            for (size_t i = 0; i < last; )
+            {
+                const uint64_t hash = hash_element(tokens[i]);
+                const bool     seen = index.find(hash, [&](uint32_t at) { return tokens[at] == tokens[i]; }) != string_index::npos;
+                if (stable)
+                {
+                    if (!seen)
+                    {
+                        if (kept != i)
+                        {
+                            tokens[kept] = std::move(tokens[i]);
+                        }
+                        index.insert(hash, static_cast<uint32_t>(kept++));
+                    }
+                    ++i;
+                }
+                else if (seen)
+                {
+                    if (i != --last)
+                    {
+                        tokens[i] = std::move(tokens[last]);
+                    }
+                }
+                else
+                {
+                    index.insert(hash, static_cast<uint32_t>(i++));
+                }
+            }
+            tokens.erase(tokens.begin() + static_cast<std::ptrdiff_t>(stable ? kept : last), tokens.end());
+        }
+    }
+
+    /**
+     * @brief Inplace removal of all duplicate elements in a vector, keeping the
+     *        first occurrence of each in its original order. Runs in expected
+     *        O(n) with an open-addressing hash index, and only needs == and a
+     *        hash (std::hash, or a fast built-in one for string-like elements).
+     * @tparam T - arbitrary datatype.
+     * @param tokens - vector of strings.
+     */
+    template<typename T>
+    inline void drop_duplicate_stable(std::vector<T> &tokens)
+    {
+        detail::drop_duplicate_hashed(tokens, true);
+    }
+
+    /**
+     * @brief Removal of all duplicate elements in a vector, keeping the
+     *        first occurrence of each in its original order.
+     * @tparam T - arbitrary datatype.
+     * @param tokens - vector of strings.
+     * @return vector of non-duplicate tokens.
      */
-    template<template<typename, typename...> typename Container, typename... Args>
-    inline Container<std::string> drop_empty_copy(Container<std::string, Args...> tokens)
+    template<typename T>
+    inline std::vector<T> drop_duplicate_stable_copy(std::vector<T> tokens)
     {
-        drop_empty(tokens);
+        drop_duplicate_stable(tokens);
         return tokens;
     }
 
     /**
-     * @brief Inplace removal of all duplicate strings in a vector<string> where order is not to be maintained
-     *        Taken from: C++ Primer V5
+     * @brief Inplace removal of all duplicate elements in a vector where order
+     *        is not to be maintained. Like drop_duplicate_stable, but moves
+     *        fewer elements; the remaining ones are neither sorted nor in
+     *        their original order.
      * @tparam T - arbitrary datatype.
      * @param tokens - vector of strings.
-     * @return vector of non-duplicate tokens.
      */
     template<typename T>
-    inline void drop_duplicate(std::vector<T> &tokens)
+    inline void drop_duplicate_unordered(std::vector<T> &tokens)
     {
-        std::sort(tokens.begin(), tokens.end());
-        auto end_unique = std::unique(tokens.begin(), tokens.end());
-        tokens.erase(end_unique, tokens.end());
+        detail::drop_duplicate_hashed(tokens, false);
     }
 
     /**
-     * @brief Removal of all duplicate strings in a vector<string> where order is not to be maintained
-     *        Taken from: C++ Primer V5
+     * @brief Removal of all duplicate elements in a vector where order is not
+     *        to be maintained.
      * @tparam T - arbitrary datatype.
      * @param tokens - vector of strings.
      * @return vector of non-duplicate tokens.
      */
     template<typename T>
-    inline std::vector<T> drop_duplicate_copy(std::vector<T> tokens)
+    inline std::vector<T> drop_duplicate_unordered_copy(std::vector<T> tokens)
     {
-        std::sort(tokens.begin(), tokens.end());
-        auto end_unique = std::unique(tokens.begin(), tokens.end());
-        tokens.erase(end_unique, tokens.end());
+        drop_duplicate_unordered(tokens);
         return tokens;
     }
 
 #ifdef STRUTIL_ENABLE_PARALLEL
+    namespace detail
+    {
+        // Sorts blocks of at least parallel_grain() elements on the shared
+        // pool, then merges neighbouring runs pairwise, each round of merges
+        // in parallel. Small ranges and single-thread pools use std::sort.
+        template<typename RandomIt, typename Compare>
+        inline void parallel_sort(RandomIt first, RandomIt last, Compare comp)
+        {
+            const std::shared_ptr<thread_pool> pool = parallel_pool();
+            const size_t count  = static_cast<size_t>(last - first);
+            const size_t blocks = std::min(pool->concurrency() * 4, count / parallel_grain());
+            if (blocks <= 1 || pool->concurrency() == 1)
+            {
+                std::sort(first, last, comp);
+                return;
+            }
+
+            std::vector<RandomIt> bounds(blocks + 1);
+            for (size_t i = 0; i <= blocks; ++i)
+            {
+                bounds[i] = first + static_cast<std::ptrdiff_t>(count / blocks * i + std::min(i, count % blocks));
+            }
+            pool->parallel_for(blocks, 1, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    std::sort(bounds[i], bounds[i + 1], comp);
+                }
+            });
+            for (size_t width = 1; width < blocks; width *= 2)
+            {
+                pool->parallel_for((blocks + 2 * width - 1) / (2 * width), 1, [&](size_t begin, size_t end)
+                {
+                    for (size_t pair = begin; pair < end; ++pair)
+                    {
+                        const size_t low = pair * 2 * width;
+                        if (low + width < blocks)
+                        {
+                            std::inplace_merge(bounds[low], bounds[low + width], bounds[std::min(low + 2 * width, blocks)], comp);
+                        }
+                    }
+                });
+            }
+        }
+    }
+
     /**
-     * @brief Parallel variant of drop_duplicate. Uses std::execution::par.
+     * @brief Parallel variant of drop_duplicate. Sorts on the shared thread_pool.
      *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
-     *        Prefer this only when tokens is large enough that the
-     *        thread-spinup cost is amortized (typically >= ~10k elements).
+     *        Vectors of at most parallel_grain() elements are handled serially.
      * @tparam T - arbitrary datatype.
      * @param tokens - vector of strings.
      */
     template<typename T>
     inline void drop_duplicate_par(std::vector<T> &tokens)
     {
-        std::sort(std::execution::par, tokens.begin(), tokens.end());
+        detail::parallel_sort(tokens.begin(), tokens.end(), std::less<T>());
         auto end_unique = std::unique(tokens.begin(), tokens.end());
         tokens.erase(end_unique, tokens.end());
     }
 
     /**
-     * @brief Parallel variant of drop_duplicate_copy. Uses std::execution::par.
+     * @brief Parallel variant of drop_duplicate_copy. Sorts on the shared thread_pool.
      *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
      * @tparam T - arbitrary datatype.
      * @param tokens - vector of strings (taken by value).
@@ -775,47 +8048,580 @@ namespace strutil
         return std::regex_match(str, regex);
     }
 
+    /**
+     * @brief Checks if input std::string str matches specified dfa_regex regex.
+     * @param str - std::string to be checked.
+     * @param regex - the regular expression, run by the built-in DFA engine.
+     * @return True if regex matches str, false otherwise.
+     */
+    inline bool matches(const std::string & str, const dfa_regex & regex)
+    {
+        return regex.matches(str);
+    }
+
+    namespace detail
+    {
+        // The 8 bytes of str from offset depth as a big-endian integer,
+        // zero-padded past the end, so integer order is byte order.
+        inline uint64_t string_key(std::string_view str, size_t depth)
+        {
+            if (depth >= str.size())
+            {
+                return 0;
+            }
+            const size_t n = std::min<size_t>(str.size() - depth, 8);
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if (n == 8)
+            {
+                uint64_t word;
+                std::memcpy(&word, str.data() + depth, 8);
+                return __builtin_bswap64(word);
+            }
+#endif
+            uint64_t key = 0;
+            for (size_t i = 0; i < 8; ++i)
+            {
+                key = (key << 8) | (i < n ? static_cast<unsigned char>(str[depth + i]) : 0u);
+            }
+            return key;
+        }
+
+        // Multikey quicksort over 8-byte cached keys: entries carry the key
+        // of their string at the current depth, so partitioning compares
+        // integers without touching the strings; only the group equal to the
+        // pivot reloads keys, 8 bytes further in. Strings in a range share
+        // their first depth bytes.
+        struct string_sort_entry
+        {
+            uint64_t key;
+            size_t   index;
+        };
+
+        template<typename Fork>
+        class string_sorter
+        {
+        public:
+            string_sorter(const std::vector<std::string_view> & views, const Fork & fork) : views_(views), fork_(fork)
+            {
+            }
+
+            void sort(string_sort_entry * first, string_sort_entry * last, size_t depth, unsigned budget) const
+            {
+                for (;;)
+                {
+                    const size_t count = static_cast<size_t>(last - first);
+                    if (count < 32 || budget-- == 0)
+                    {
+                        // Small ranges, and ranges whose pivots keep going bad.
+                        std::sort(first, last, [this, depth](const string_sort_entry & a, const string_sort_entry & b)
+                        {
+                            return a.key != b.key ? a.key < b.key : suffix(a, depth) < suffix(b, depth);
+                        });
+                        return;
+                    }
+
+                    const uint64_t pivot = median(first[0].key, first[count / 2].key, first[count - 1].key);
+                    string_sort_entry * lt = first;
+                    string_sort_entry * gt = last;
+                    for (string_sort_entry * it = first; it < gt; )
+                    {
+                        if (it->key < pivot)
+                        {
+                            std::swap(*lt++, *it++);
+                        }
+                        else if (it->key > pivot)
+                        {
+                            std::swap(*it, *--gt);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+
+                    // Strings that end within this key are equal up to their
+                    // length and precede the longer ones: order them by size.
+                    string_sort_entry * ended = std::partition(lt, gt, [this, depth](const string_sort_entry & e)
+                    {
+                        return views_[e.index].size() <= depth + 8;
+                    });
+                    std::sort(lt, ended, [this](const string_sort_entry & a, const string_sort_entry & b)
+                    {
+                        return views_[a.index].size() < views_[b.index].size();
+                    });
+
+                    if (lt == first && gt == last)
+                    {
+                        // Nothing split off: go one key deeper in place.
+                        first = ended;
+                    }
+                    else
+                    {
+                        fork_(count, [&](size_t part)
+                        {
+                            if (part == 0)
+                            {
+                                sort(first, lt, depth, budget);
+                            }
+                            else if (part == 1)
+                            {
+                                sort(gt, last, depth, budget);
+                            }
+                            else
+                            {
+                                load(ended, gt, depth + 8);
+                                sort(ended, gt, depth + 8, budget);
+                            }
+                        });
+                        return;
+                    }
+                    depth += 8;
+                    last = gt;
+                    load(first, last, depth);
+                }
+            }
+
+            void load(string_sort_entry * first, string_sort_entry * last, size_t depth) const
+            {
+                for (; first != last; ++first)
+                {
+                    first->key = string_key(views_[first->index], depth);
+                }
+            }
+
+        private:
+            std::string_view suffix(const string_sort_entry & e, size_t depth) const
+            {
+                const std::string_view str = views_[e.index];
+                return str.substr(std::min(depth, str.size()));
+            }
+
+            static uint64_t median(uint64_t a, uint64_t b, uint64_t c)
+            {
+                return std::max(std::min(a, b), std::min(std::max(a, b), c));
+            }
+
+            const std::vector<std::string_view> & views_;
+            const Fork &                          fork_;
+        };
+
+        template<typename T>
+        constexpr bool is_sortable_string_v = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+        // Order of views under string_sorter, as entries whose index points
+        // into views. fork(count, part) runs part(0), part(1) and part(2),
+        // possibly concurrently; fill(n, range) calls range(first, last) on
+        // blocks covering [0, n), possibly concurrently.
+        template<typename Fork, typename Fill>
+        inline std::vector<string_sort_entry> string_sort_order(const std::vector<std::string_view> & views, const Fork & fork, const Fill & fill)
+        {
+            std::vector<string_sort_entry> entries(views.size());
+            const string_sorter<Fork>      sorter(views, fork);
+            fill(entries.size(), [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    entries[i].index = i;
+                }
+                sorter.load(entries.data() + first, entries.data() + last, 0);
+            });
+
+            unsigned budget = 0;
+            for (size_t n = entries.size(); n != 0; n >>= 1)
+            {
+                budget += 2;
+            }
+            sorter.sort(entries.data(), entries.data() + entries.size(), 0, budget);
+            return entries;
+        }
+
+        // Moves the elements of strs into the order given by entries, or its reverse.
+        template<typename T, typename Fill>
+        inline void permute_sorted(std::vector<T> & strs, const std::vector<string_sort_entry> & entries, bool descending, const Fill & fill)
+        {
+            const size_t   count = strs.size();
+            std::vector<T> sorted(count);
+            fill(count, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    sorted[i] = std::move(strs[entries[descending ? count - 1 - i : i].index]);
+                }
+            });
+            strs.swap(sorted);
+        }
+
+        // Sorts a vector of std::string or std::string_view with string_sorter.
+        template<typename T, typename Fork, typename Fill>
+        inline void string_sort(std::vector<T> & strs, bool descending, const Fork & fork, const Fill & fill)
+        {
+            if (strs.size() < 64)
+            {
+                if (descending)
+                {
+                    std::sort(strs.begin(), strs.end(), std::greater<T>());
+                }
+                else
+                {
+                    std::sort(strs.begin(), strs.end());
+                }
+                return;
+            }
+
+            std::vector<std::string_view> views(strs.size());
+            fill(views.size(), [&](size_t first, size_t last)
+            {
+                std::copy(strs.begin() + static_cast<std::ptrdiff_t>(first), strs.begin() + static_cast<std::ptrdiff_t>(last),
+                          views.begin() + static_cast<std::ptrdiff_t>(first));
+            });
+            permute_sorted(strs, string_sort_order(views, fork, fill), descending, fill);
+        }
+
+        // Decorate-sort-undecorate: make_key(str, out) writes the sort key of
+        // str to out and returns its size, or only returns the size when out
+        // is null. All keys share one buffer, sized by a first pass. Elements
+        // with equal keys keep their relative order.
+        template<typename T, typename MakeKey, typename Fork, typename Fill>
+        inline void sort_by_keys(std::vector<T> & strs, const MakeKey & make_key, const Fork & fork, const Fill & fill)
+        {
+            const size_t        count = strs.size();
+            std::vector<size_t> offsets(count + 1, 0);
+            fill(count, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    offsets[i + 1] = make_key(std::string_view(strs[i]), nullptr);
+                }
+            });
+            for (size_t i = 0; i < count; ++i)
+            {
+                offsets[i + 1] += offsets[i];
+            }
+
+            std::unique_ptr<char[]>       blob(new char[std::max<size_t>(offsets.back(), 1)]);
+            std::vector<std::string_view> keys(count);
+            fill(count, [&](size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    make_key(std::string_view(strs[i]), blob.get() + offsets[i]);
+                    keys[i] = std::string_view(blob.get() + offsets[i], offsets[i + 1] - offsets[i]);
+                }
+            });
+
+            std::vector<string_sort_entry> entries = string_sort_order(keys, fork, fill);
+            for (auto run = entries.begin(); run != entries.end(); )
+            {
+                const auto run_end = std::find_if(run + 1, entries.end(), [&](const string_sort_entry & e)
+                {
+                    return keys[e.index] != keys[run->index];
+                });
+                std::sort(run, run_end, [](const string_sort_entry & a, const string_sort_entry & b) { return a.index < b.index; });
+                run = run_end;
+            }
+            permute_sorted(strs, entries, false, fill);
+        }
+
+        // Key of sorting_ascending_ci: str with ASCII letters lowered.
+        inline size_t fold_case_key(std::string_view str, char * out)
+        {
+            if (out != nullptr)
+            {
+                std::memcpy(out, str.data(), str.size());
+                case_kernels_for_cpu().convert(out, out + str.size(), 'A');
+            }
+            return str.size();
+        }
+
+        // Key of sorting_natural: runs of digits become '0', the number of
+        // significant digits (one byte below 255, else 0xFF and 8 bytes big
+        // endian) and the significant digits, so byte order compares them
+        // by value; other characters are copied, lowered if ignore_case.
+        inline size_t natural_key(std::string_view str, bool ignore_case, char * out)
+        {
+            size_t size = 0;
+            const auto put = [&](char c)
+            {
+                if (out != nullptr)
+                {
+                    out[size] = c;
+                }
+                ++size;
+            };
+            const auto is_digit = [](char c) { return c >= '0' && c <= '9'; };
+
+            for (size_t i = 0; i < str.size(); )
+            {
+                if (!is_digit(str[i]))
+                {
+                    const char c = str[i++];
+                    put(ignore_case && c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c);
+                    continue;
+                }
+                size_t run_end = i;
+                while (run_end < str.size() && is_digit(str[run_end]))
+                {
+                    ++run_end;
+                }
+                while (i < run_end && str[i] == '0')
+                {
+                    ++i;
+                }
+                const uint64_t digits = run_end - i;
+                put('0');
+                if (digits < 0xFF)
+                {
+                    put(static_cast<char>(digits));
+                }
+                else
+                {
+                    put(static_cast<char>(0xFF));
+                    for (int shift = 56; shift >= 0; shift -= 8)
+                    {
+                        put(static_cast<char>((digits >> shift) & 0xFF));
+                    }
+                }
+                for (; i < run_end; ++i)
+                {
+                    put(str[i]);
+                }
+            }
+            return size;
+        }
+
+        // Calls sort(fork, fill) with the serial fork and fill.
+        template<typename Sort>
+        inline void run_string_sort(const Sort & sort)
+        {
+            const auto fork = [](size_t, const auto & part) { part(0); part(1); part(2); };
+            const auto fill = [](size_t count, const auto & range) { range(size_t(0), count); };
+            sort(fork, fill);
+        }
+
+        template<typename T>
+        inline void string_sort(std::vector<T> & strs, bool descending)
+        {
+            run_string_sort([&](const auto & fork, const auto & fill) { string_sort(strs, descending, fork, fill); });
+        }
+
+        template<typename T>
+        inline void sort_ci(std::vector<T> & strs)
+        {
+            run_string_sort([&](const auto & fork, const auto & fill) { sort_by_keys(strs, fold_case_key, fork, fill); });
+        }
+
+        template<typename T>
+        inline void sort_natural(std::vector<T> & strs, bool ignore_case)
+        {
+            const auto make_key = [ignore_case](std::string_view str, char * out) { return natural_key(str, ignore_case, out); };
+            run_string_sort([&](const auto & fork, const auto & fill) { sort_by_keys(strs, make_key, fork, fill); });
+        }
+    }
+
     /**
      * @brief Sort input std::vector<std::string> strs in ascending order.
+     *        std::string and std::string_view elements are sorted by a
+     *        multikey quicksort over cached 8-byte key prefixes, other
+     *        datatypes by std::sort.
      * @param strs - std::vector<std::string> to be checked.
      */
     template<typename T>
     inline void sorting_ascending(std::vector<T> &strs)
     {
-        std::sort(strs.begin(), strs.end());
+        if constexpr (detail::is_sortable_string_v<T>)
+        {
+            detail::string_sort(strs, false);
+        }
+        else
+        {
+            std::sort(strs.begin(), strs.end());
+        }
     }
 
     /**
      * @brief Sorted input std::vector<std::string> strs in descending order.
+     *        std::string and std::string_view elements use the same string
+     *        sort as sorting_ascending.
      * @param strs - std::vector<std::string> to be checked.
      */
     template<typename T>
     inline void sorting_descending(std::vector<T> &strs)
     {
-        std::sort(strs.begin(), strs.end(), std::greater<T>());
+        if constexpr (detail::is_sortable_string_v<T>)
+        {
+            detail::string_sort(strs, true);
+        }
+        else
+        {
+            std::sort(strs.begin(), strs.end(), std::greater<T>());
+        }
+    }
+
+    /**
+     * @brief Sort input string_table strs in ascending order.
+     * @param strs - string_table to be sorted.
+     */
+    inline void sorting_ascending(string_table &strs)
+    {
+        std::vector<std::string_view> views(strs.begin(), strs.end());
+        detail::string_sort(views, false);
+        strs.assign(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Sort input string_table strs in descending order.
+     * @param strs - string_table to be sorted.
+     */
+    inline void sorting_descending(string_table &strs)
+    {
+        std::vector<std::string_view> views(strs.begin(), strs.end());
+        detail::string_sort(views, true);
+        strs.assign(views.begin(), views.end());
+    }
+
+    /**
+     * @brief Sort input std::vector strs in ascending order ignoring the case
+     *        of ASCII letters, e.g. "apple" < "Banana" < "cherry". Strings that
+     *        differ only in case keep their relative order. The lowered keys
+     *        are built once up front and sorted like sorting_ascending, instead
+     *        of lowering both strings in every comparison.
+     * @param strs - std::vector of std::string or std::string_view to be sorted.
+     */
+    template<typename T>
+    inline void sorting_ascending_ci(std::vector<T> &strs)
+    {
+        detail::sort_ci(strs);
+    }
+
+    /**
+     * @brief Sort input std::vector strs in natural order: runs of digits
+     *        compare by numeric value, so "file2" < "file10". Leading zeros are
+     *        ignored ("a01" and "a1" are equal) and strings with equal sort keys
+     *        keep their relative order. The keys are built once up front and
+     *        sorted like sorting_ascending, instead of parsing both strings in
+     *        every comparison.
+     * @param strs - std::vector of std::string or std::string_view to be sorted.
+     * @param ignore_case - if true, ASCII letters compare ignoring case.
+     */
+    template<typename T>
+    inline void sorting_natural(std::vector<T> &strs, bool ignore_case = false)
+    {
+        detail::sort_natural(strs, ignore_case);
     }
 
 #ifdef STRUTIL_ENABLE_PARALLEL
+    namespace detail
+    {
+        // Calls sort(fork, fill) on the shared pool: partitions above
+        // parallel_grain() elements sort their three parts as concurrent
+        // tasks, and the key and move passes are split in blocks. Falls back
+        // to the serial versions for count up to the grain.
+        template<typename Sort>
+        inline void run_string_sort_par(size_t count, const Sort & sort)
+        {
+            const std::shared_ptr<thread_pool> pool  = parallel_pool();
+            const size_t                       grain = parallel_grain();
+            if (pool->concurrency() == 1 || count <= grain)
+            {
+                run_string_sort(sort);
+                return;
+            }
+            const auto fork = [&](size_t n, const auto & part)
+            {
+                if (n <= grain)
+                {
+                    part(0);
+                    part(1);
+                    part(2);
+                    return;
+                }
+                pool->parallel_for(3, 1, [&](size_t first, size_t last)
+                {
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        part(i);
+                    }
+                });
+            };
+            const auto fill = [&](size_t n, const auto & range) { pool->parallel_for(n, grain, range); };
+            sort(fork, fill);
+        }
+
+        template<typename T>
+        inline void string_sort_par(std::vector<T> & strs, bool descending)
+        {
+            run_string_sort_par(strs.size(), [&](const auto & fork, const auto & fill) { string_sort(strs, descending, fork, fill); });
+        }
+    }
+
     /**
-     * @brief Parallel variant of sorting_ascending. Uses std::execution::par.
+     * @brief Parallel variant of sorting_ascending. Sorts on the shared thread_pool;
+     *        std::string and std::string_view elements use a parallel
+     *        multikey quicksort, other datatypes a parallel merge sort.
      *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
      * @param strs - std::vector<T> to be sorted.
      */
     template<typename T>
     inline void sorting_ascending_par(std::vector<T> &strs)
     {
-        std::sort(std::execution::par, strs.begin(), strs.end());
+        if constexpr (detail::is_sortable_string_v<T>)
+        {
+            detail::string_sort_par(strs, false);
+        }
+        else
+        {
+            detail::parallel_sort(strs.begin(), strs.end(), std::less<T>());
+        }
     }
 
     /**
-     * @brief Parallel variant of sorting_descending. Uses std::execution::par.
+     * @brief Parallel variant of sorting_descending. Sorts on the shared thread_pool.
      *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
      * @param strs - std::vector<T> to be sorted.
      */
     template<typename T>
     inline void sorting_descending_par(std::vector<T> &strs)
     {
-        std::sort(std::execution::par, strs.begin(), strs.end(), std::greater<T>());
+        if constexpr (detail::is_sortable_string_v<T>)
+        {
+            detail::string_sort_par(strs, true);
+        }
+        else
+        {
+            detail::parallel_sort(strs.begin(), strs.end(), std::greater<T>());
+        }
+    }
+
+    /**
+     * @brief Parallel variant of sorting_ascending_ci. Builds the keys and sorts
+     *        them on the shared thread_pool.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param strs - std::vector of std::string or std::string_view to be sorted.
+     */
+    template<typename T>
+    inline void sorting_ascending_ci_par(std::vector<T> &strs)
+    {
+        detail::run_string_sort_par(strs.size(), [&](const auto & fork, const auto & fill)
+        {
+            detail::sort_by_keys(strs, detail::fold_case_key, fork, fill);
+        });
+    }
+
+    /**
+     * @brief Parallel variant of sorting_natural. Builds the keys and sorts
+     *        them on the shared thread_pool.
+     *        Only available when STRUTIL_ENABLE_PARALLEL is defined.
+     * @param strs - std::vector of std::string or std::string_view to be sorted.
+     * @param ignore_case - if true, ASCII letters compare ignoring case.
+     */
+    template<typename T>
+    inline void sorting_natural_par(std::vector<T> &strs, bool ignore_case = false)
+    {
+        const auto make_key = [ignore_case](std::string_view str, char * out) { return detail::natural_key(str, ignore_case, out); };
+        detail::run_string_sort_par(strs.size(), [&](const auto & fork, const auto & fill)
+        {
+            detail::sort_by_keys(strs, make_key, fork, fill);
+        });
     }
 #endif // STRUTIL_ENABLE_PARALLEL
 
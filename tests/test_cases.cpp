@@ -5,6 +5,10 @@
 #include <gtest/gtest.h>
 #include "strutil.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 /*
 * Comparison tests
 */
@@ -29,6 +33,65 @@ TEST(Compare, compare_ignore_case)
     EXPECT_EQ(true, strutil::compare_ignore_case("", ""));
 }
 
+TEST(Compare, compare_ignore_case_long)
+{
+    const std::string upper = "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG @[`{ 0123456789";
+    std::string lower = strutil::to_lower(upper);
+
+    EXPECT_EQ(true, strutil::compare_ignore_case(upper, lower));
+
+    // '@' / '`' and '[' / '{' differ only in bit 0x20 but are not letters.
+    EXPECT_EQ(false, strutil::compare_ignore_case("@[", "`{"));
+
+    // A mismatch in the last block or in the scalar tail must be found.
+    for (size_t i = 0; i < lower.size(); ++i)
+    {
+        std::string changed = lower;
+        changed[i] = '#';
+        EXPECT_EQ(false, strutil::compare_ignore_case(upper, changed)) << "mismatch at " << i;
+    }
+
+    // Different lengths are never equal.
+    EXPECT_EQ(false, strutil::compare_ignore_case(upper, lower.substr(1)));
+}
+
+TEST(Compare, ascii_case_kernels_match_scalar)
+{
+    std::string input;
+    for (int i = 0; i < 300; ++i)
+    {
+        input += static_cast<char>(i);
+    }
+
+    for (size_t length = 0; length <= input.size(); length += 7)
+    {
+        for (char lo : { 'A', 'a' })
+        {
+            std::string expected = input.substr(0, length);
+            strutil::detail::ascii_case_scalar(&expected[0], &expected[0] + expected.size(), lo);
+
+            std::string actual = input.substr(0, length);
+            strutil::detail::case_kernels_for_cpu().convert(&actual[0], &actual[0] + actual.size(), lo);
+            EXPECT_EQ(expected, actual);
+#if defined(STRUTIL_X86_SIMD)
+            actual = input.substr(0, length);
+            strutil::detail::ascii_case_sse2(&actual[0], &actual[0] + actual.size(), lo);
+            EXPECT_EQ(expected, actual);
+#endif
+        }
+
+        const std::string folded = strutil::to_upper(input.substr(0, length));
+        EXPECT_EQ(true, strutil::detail::equal_ignore_case_scalar(input.data(), folded.data(), length));
+#if defined(STRUTIL_X86_SIMD)
+        EXPECT_EQ(true, strutil::detail::equal_ignore_case_sse2(input.data(), folded.data(), length));
+        if (strutil::detail::cpu().avx2)
+        {
+            EXPECT_EQ(true, strutil::detail::equal_ignore_case_avx2(input.data(), folded.data(), length));
+        }
+#endif
+    }
+}
+
 TEST(Compare, starts_with_str)
 {
     EXPECT_EQ(true, strutil::starts_with("m_DiffuseTexture", "m_"));
@@ -97,6 +160,54 @@ TEST(Compare, contains_char)
     EXPECT_EQ(false, strutil::contains("", 'z'));
 }
 
+TEST(Compare, contains_searcher)
+{
+    const strutil::searcher short_needle("fuse");
+    EXPECT_EQ(true, strutil::contains("DiffuseTexture_m", short_needle));
+    EXPECT_EQ(false, strutil::contains("Diffus", short_needle));
+
+    const std::string long_text = std::string(100, 'x') + "needle-longer-than-sixteen-bytes" + std::string(100, 'y');
+    const strutil::searcher long_needle("needle-longer-than-sixteen-bytes");
+    EXPECT_EQ(100u, long_needle.find(long_text));
+    EXPECT_EQ(100u, long_needle.rfind(long_text));
+    EXPECT_EQ(std::string_view::npos, long_needle.find(long_text, 101));
+    EXPECT_EQ(std::string_view::npos, long_needle.rfind(long_text, 99));
+    EXPECT_EQ(false, strutil::contains(std::string_view(long_text).substr(0, 131), long_needle));
+
+    EXPECT_EQ(3u, strutil::searcher("").find("abc", 3));
+}
+
+TEST(Compare, contains_any)
+{
+    const strutil::multi_matcher keywords({"error", "fatal", "panic"});
+    EXPECT_EQ(3u, keywords.size());
+    EXPECT_EQ(true, strutil::contains_any("kernel panic: not syncing", keywords));
+    EXPECT_EQ(false, strutil::contains_any("all good", keywords));
+    EXPECT_EQ(false, strutil::contains_any("", keywords));
+
+    const strutil::multi_matcher none(std::vector<std::string>{ "" });
+    EXPECT_EQ(false, strutil::contains_any("anything", none));
+}
+
+TEST(Compare, find_first_of_any)
+{
+    const strutil::multi_matcher needles({"cd", "bcde", "bc", "x"});
+    const auto first = strutil::find_first_of_any("abcdef", needles);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(1u, first->first);
+    EXPECT_EQ(1u, first->second);
+
+    EXPECT_FALSE(strutil::find_first_of_any("yyy", needles).has_value());
+}
+
+TEST(Compare, find_all_matches)
+{
+    const strutil::multi_matcher needles(std::vector<std::string>{ "he", "she", "his", "hers" });
+    const std::vector<std::pair<size_t, size_t>> expected = { {1, 1}, {0, 2}, {3, 2} };
+    EXPECT_EQ(expected, strutil::find_all_matches("ushers", needles));
+    EXPECT_TRUE(strutil::find_all_matches("", needles).empty());
+}
+
 TEST(Compare, matches)
 {
     const std::regex check_mail("^[a-zA-Z0-9_.+-]+@[a-zA-Z0-9-]+\\.[a-zA-Z0-9-.]+$");
@@ -119,6 +230,88 @@ TEST(Compare, matches)
     EXPECT_EQ(true, strutil::matches("", maybe_digits));
 }
 
+TEST(Compare, matches_dfa_regex)
+{
+    const strutil::dfa_regex check_mail("^[a-zA-Z0-9_.+-]+@[a-zA-Z0-9-]+\\.[a-zA-Z0-9-.]+$");
+    EXPECT_EQ(true, strutil::matches("jon.doe@somehost.com", check_mail));
+    EXPECT_EQ(false, strutil::matches("jon.doe@", check_mail));
+
+    const strutil::dfa_regex digits("\\d{2,4}(?:-\\d+)?");
+    EXPECT_EQ(true,  strutil::matches("123-45", digits));
+    EXPECT_EQ(false, strutil::matches("1-45", digits));
+    EXPECT_EQ(false, strutil::matches("12345", digits));
+    EXPECT_EQ(true,  strutil::matches("", strutil::dfa_regex("[0-9]*")));
+
+    const strutil::dfa_regex keyword("get|post", std::regex::icase);
+    EXPECT_EQ(true,  strutil::matches("GET", keyword));
+    EXPECT_EQ(false, strutil::matches("PUT", keyword));
+    EXPECT_TRUE(keyword.search("http POST /"));
+
+    // Leftmost match, preferring earlier alternatives and honouring lazy
+    // quantifiers, as std::regex does.
+    const auto first = strutil::dfa_regex("a|ab").find("xab");
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(std::make_pair(size_t(1), size_t(1)), *first);
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(3)), *strutil::dfa_regex("<.*?>").find("<a><b>"));
+    EXPECT_FALSE(strutil::dfa_regex("^b").find("ab").has_value());
+    EXPECT_EQ(std::make_pair(size_t(3), size_t(1)), *strutil::dfa_regex("b$").find("abab"));
+
+    // An iteration past a quantifier's minimum may not match empty, so the
+    // body falls back to a longer path, as in ECMAScript.
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(1)), *strutil::dfa_regex("(.??|b[ab](?:[ab]*b+?.+){1,2}|\\d+a+)?").find("x"));
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(1)), *strutil::dfa_regex("(?:.*?b*?){1,2}").find("cxccaxbxc"));
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(1)), *strutil::dfa_regex("c?\?(?:[ab]*?[^a]?|ca){1,2}").find("aabx"));
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(3)), *strutil::dfa_regex("(?:(?:[ab]*?)*)").find("bab"));
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(0)), *strutil::dfa_regex("(?:a?\?){2}").find("aa"));
+
+    EXPECT_THROW(strutil::dfa_regex("(a"), std::regex_error);
+    EXPECT_THROW(strutil::dfa_regex("(a)\\1"), std::regex_error);
+    EXPECT_THROW(strutil::dfa_regex("a(?=b)"), std::regex_error);
+    EXPECT_THROW(strutil::dfa_regex("a**"), std::regex_error);
+}
+
+TEST(Compare, matches_dfa_regex_long_input)
+{
+    // Would exhaust the stack of a backtracking engine.
+    std::string text(1 << 22, 'a');
+    text[text.size() / 2] = 'b';
+    EXPECT_EQ(true, strutil::matches(text, strutil::dfa_regex("(a|b)*")));
+    EXPECT_EQ(false, strutil::matches(text, strutil::dfa_regex("(a|c)*")));
+}
+
+TEST(Compare, dfa_regex_concurrent_calls)
+{
+    // Calls on one dfa_regex from several threads each get a cache of their own.
+    const strutil::dfa_regex pattern("(a|b)*a(a|b){6}c");
+    std::string text;
+    for (int i = 0; i < 5000; ++i)
+    {
+        text += (i * 7919 % 13 < 6) ? 'a' : 'b';
+    }
+    text += "c";
+    const auto expected = pattern.find(text);
+    const bool whole    = pattern.matches(text);
+    ASSERT_TRUE(expected.has_value());
+
+    std::atomic<int>         agreed { 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (int i = 0; i < 50; ++i)
+            {
+                agreed += pattern.find(text) == expected && pattern.search(text) && pattern.matches(text) == whole;
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(200, agreed.load());
+}
+
 /*
  * Parsing tests
  */
@@ -198,6 +391,45 @@ TEST(Parsing, neg_bool_to_string)
     EXPECT_EQ("0", strutil::to_string<bool>(false));
 }
 
+TEST(Parsing, to_string_shortest_round_trip)
+{
+    EXPECT_EQ("0.1", strutil::to_string(0.1));
+    EXPECT_EQ("3.141592653589793", strutil::to_string(3.141592653589793));
+    EXPECT_EQ("1e+300", strutil::to_string(1e300));
+    EXPECT_EQ("-0", strutil::to_string(-0.0));
+    EXPECT_EQ("0.3", strutil::to_string(0.3f));
+    EXPECT_EQ("-9223372036854775808", strutil::to_string(std::numeric_limits<long long>::min()));
+    EXPECT_EQ("18446744073709551615", strutil::to_string(std::numeric_limits<unsigned long long>::max()));
+
+    const double value = 2.2250738585072014e-308;
+    EXPECT_EQ(value, strutil::parse_string<double>(strutil::to_string(value)));
+}
+
+TEST(Parsing, to_string_into_buffer)
+{
+    char buffer[8];
+    const auto written = strutil::to_string(-1234, buffer, buffer + sizeof(buffer));
+    ASSERT_EQ(std::errc{}, written.ec);
+    EXPECT_EQ("-1234", std::string(buffer, written.ptr));
+
+    const auto too_small = strutil::to_string(123456789, buffer, buffer + sizeof(buffer));
+    EXPECT_EQ(std::errc::value_too_large, too_small.ec);
+    EXPECT_EQ(buffer + sizeof(buffer), too_small.ptr);
+
+    EXPECT_EQ(std::errc::value_too_large, strutil::to_string(true, buffer, buffer).ec);
+}
+
+TEST(Parsing, append_to_string)
+{
+    std::string line = "cpu=";
+    strutil::append_to_string(line, 0.25);
+    line += ' ';
+    strutil::append_to_string(line, 42u);
+    line += ' ';
+    strutil::append_to_string(line, false);
+    EXPECT_EQ("cpu=0.25 42 0", line);
+}
+
 TEST(Parsing, string_to_short_int)
 {
     EXPECT_EQ(-255, strutil::parse_string<short int>("-255"));
@@ -387,10 +619,9 @@ TEST(TryParsing, value_or_provides_default)
 
 TEST(TryParsing, custom_type_via_primary_template)
 {
-    // The float/double/long-double overloads use the strtof-based
-    // specialization; everything else (including user-defined types like
-    // Point2D, defined above) falls through to the primary template's
-    // istringstream-based path. Exercise that path explicitly.
+    // Arithmetic types are handled by parse_number; everything else
+    // (including user-defined types like Point2D, defined above) falls
+    // through to the istringstream-based path. Exercise that path explicitly.
     const auto good = strutil::try_parse_string<Point2D>("3,4");
     ASSERT_TRUE(good.has_value());
     EXPECT_EQ((Point2D{ 3, 4 }), *good);
@@ -401,6 +632,159 @@ TEST(TryParsing, custom_type_via_primary_template)
     EXPECT_FALSE(bad.has_value());
 }
 
+/*
+* parse_number — allocation-free, locale-independent numeric parsing with
+* error position and optional strict mode.
+*/
+
+TEST(ParseNumber, integers)
+{
+    auto r = strutil::parse_number<int>("-255");
+    ASSERT_TRUE(r);
+    EXPECT_EQ(-255, r.value);
+    EXPECT_EQ(4u, r.pos);
+
+    // Leading white space and '+' are accepted, like stream extraction.
+    r = strutil::parse_number<int>(" \t+42");
+    ASSERT_TRUE(r);
+    EXPECT_EQ(42, r.value);
+    EXPECT_EQ(5u, r.pos);
+
+    EXPECT_FALSE(strutil::parse_number<int>("+-1"));
+    EXPECT_FALSE(strutil::parse_number<int>(""));
+    EXPECT_FALSE(strutil::parse_number<int>("   "));
+
+    EXPECT_EQ(18446744073709551615ull, strutil::parse_number<unsigned long long>("18446744073709551615").value);
+    EXPECT_EQ(-128, strutil::parse_number<short>("-128").value);
+}
+
+TEST(ParseNumber, trailing_characters_and_strict_mode)
+{
+    auto lenient = strutil::parse_number<int>("42abc");
+    ASSERT_TRUE(lenient);
+    EXPECT_EQ(42, lenient.value);
+    EXPECT_EQ(2u, lenient.pos);
+
+    auto strict = strutil::parse_number<int>("42abc", true);
+    EXPECT_FALSE(strict);
+    EXPECT_EQ(std::errc::invalid_argument, strict.ec);
+    EXPECT_EQ(2u, strict.pos);
+    EXPECT_EQ(0, strict.value);
+
+    EXPECT_TRUE(strutil::parse_number<int>("42", true));
+    EXPECT_FALSE(strutil::parse_number<int>("42 ", true));
+
+    // The input does not need to be NUL-terminated.
+    const std::string digits = "12345";
+    const auto prefix = strutil::parse_number<int>(std::string_view(digits.data(), 3), true);
+    ASSERT_TRUE(prefix);
+    EXPECT_EQ(123, prefix.value);
+}
+
+TEST(ParseNumber, errors)
+{
+    const auto overflow = strutil::parse_number<short>("70000");
+    EXPECT_EQ(std::errc::result_out_of_range, overflow.ec);
+    EXPECT_EQ(0, overflow.value);
+
+    const auto negative = strutil::parse_number<unsigned>("-1");
+    EXPECT_EQ(std::errc::invalid_argument, negative.ec);
+    EXPECT_EQ(0u, negative.pos);
+
+    const auto garbage = strutil::parse_number<long>("  x1");
+    EXPECT_EQ(std::errc::invalid_argument, garbage.ec);
+    EXPECT_EQ(2u, garbage.pos);
+
+    EXPECT_EQ(0, strutil::parse_string<int>("99999999999"));
+    EXPECT_FALSE(strutil::try_parse_string<int>("99999999999").has_value());
+    EXPECT_FALSE(strutil::try_parse_string<unsigned>("-1").has_value());
+}
+
+TEST(ParseNumber, booleans)
+{
+    EXPECT_EQ(true,  strutil::parse_number<bool>("1").value);
+    EXPECT_EQ(false, strutil::parse_number<bool>("0").value);
+    EXPECT_EQ(std::errc::invalid_argument, strutil::parse_number<bool>("2").ec);
+    EXPECT_FALSE(strutil::parse_number<bool>("true"));
+    EXPECT_FALSE(strutil::try_parse_string<bool>("2").has_value());
+}
+
+TEST(ParseNumber, string_view_input)
+{
+    const std::string_view fields = "8080;443";
+    EXPECT_EQ(8080, strutil::parse_string<int>(fields.substr(0, 4)));
+    EXPECT_EQ(443,  strutil::try_parse_string<int>(fields.substr(5)).value_or(0));
+}
+
+TEST(ParseNumber, floats_match_strtod)
+{
+    const char * inputs[] = {
+        "0", "-0", "3.14159", "1e23", "8.589973e9", "9007199254740993", "2.2250738585072011e-308",
+        "4.9e-324", "2.4703282292062328e-324", "1.7976931348623157e308", "123456789012345678901234567890e-20",
+        "0.1000000000000000055511151231257827021181583404541015625000000000000000001", ".5", "1.",
+        "7.006492321624085354618647916449580656401309709382578858785341419448955413429303e-46",
+        "0x1.8p1", "-0x.8p-3", "0x1.0000000000001p-1075", "0x", "1e", "1e+x", "3.4028235e38"
+    };
+
+    for (const char * input : inputs)
+    {
+        char * end = nullptr;
+        const double expected = std::strtod(input, &end);
+        const auto parsed = strutil::parse_number<double>(input);
+        ASSERT_TRUE(parsed) << input;
+        EXPECT_EQ(0, std::memcmp(&expected, &parsed.value, sizeof(double))) << input;
+        EXPECT_EQ(static_cast<size_t>(end - input), parsed.pos) << input;
+
+        const float expected_float = std::strtof(input, nullptr);
+        const auto parsed_float = strutil::parse_number<float>(input);
+        if (std::isfinite(expected_float))
+        {
+            EXPECT_EQ(0, std::memcmp(&expected_float, &parsed_float.value, sizeof(float))) << input;
+        }
+        else
+        {
+            EXPECT_EQ(std::errc::result_out_of_range, parsed_float.ec) << input;
+        }
+    }
+}
+
+TEST(ParseNumber, float_special_values_and_errors)
+{
+    EXPECT_TRUE(std::isinf(strutil::parse_number<double>("-Infinity").value));
+    EXPECT_EQ(9u, strutil::parse_number<double>("-Infinity").pos);
+    EXPECT_EQ(3u, strutil::parse_number<float>("infinite").pos);
+    EXPECT_TRUE(std::isnan(strutil::parse_number<double>("nan(0x1)").value));
+    EXPECT_EQ(8u, strutil::parse_number<double>("nan(0x1)").pos);
+    EXPECT_EQ(3u, strutil::parse_number<double>("nan(").pos);
+
+    EXPECT_EQ(std::errc::result_out_of_range, strutil::parse_number<double>("1e309").ec);
+    EXPECT_EQ(std::errc::result_out_of_range, strutil::parse_number<float>("-1e39").ec);
+    EXPECT_EQ(0.0, strutil::parse_number<double>("1e-400").value);
+    EXPECT_EQ(std::errc::invalid_argument, strutil::parse_number<double>(".e1").ec);
+    EXPECT_EQ(std::errc::invalid_argument, strutil::parse_number<double>("-").ec);
+
+    // The view does not have to be NUL-terminated.
+    const std::string_view digits = "2.5e3";
+    EXPECT_EQ(2.5, strutil::parse_number<double>(digits.substr(0, 3), true).value);
+}
+
+TEST(ParseNumber, floats_ignore_global_locale)
+{
+    const char * const previous = std::setlocale(LC_NUMERIC, nullptr);
+    const std::string saved = previous ? previous : "C";
+    if (std::setlocale(LC_NUMERIC, "de_DE.UTF-8") == nullptr && std::setlocale(LC_NUMERIC, "de_DE") == nullptr)
+    {
+        GTEST_SKIP() << "de_DE locale is not available";
+    }
+
+    const double value = strutil::parse_string<double>("5.245");
+    const long double long_value = strutil::parse_string<long double>("5.245");
+    std::setlocale(LC_NUMERIC, saved.c_str());
+
+    EXPECT_EQ(5.245, value);
+    EXPECT_EQ(5.245L, long_value);
+}
+
 /*
 * Splitting and tokenizing
 */
@@ -517,6 +901,31 @@ TEST(Splitting, split_string_delim)
     EXPECT_TRUE(res.empty());
 }
 
+#ifdef STRUTIL_ENABLE_PARALLEL
+TEST(Splitting, split_par)
+{
+    strutil::set_parallel_threads(4);
+    EXPECT_EQ(strutil::split("a,,b,", ','), strutil::split_par("a,,b,", ','));
+    EXPECT_EQ(strutil::split(std::string_view(""), ','), strutil::split_par(std::string_view(""), ','));
+
+    // Large enough for several chunks; runs of delimiters and long tokens
+    // land on chunk boundaries.
+    std::string big;
+    for (int i = 0; big.size() < (size_t(5) << 20); ++i)
+    {
+        big += std::string(static_cast<size_t>(i % 7), ',') + std::string(static_cast<size_t>(i * 131 % 5000), 'x') + std::to_string(i);
+    }
+    big += ",,";
+    for (bool keep_empty : { true, false })
+    {
+        EXPECT_EQ(strutil::split(std::string_view(big), ',', keep_empty), strutil::split_par(std::string_view(big), ',', keep_empty));
+        EXPECT_EQ(strutil::split(big, ',', keep_empty), strutil::split_par(big, ',', keep_empty));
+    }
+    EXPECT_EQ((std::vector<std::string_view> { big }), strutil::split_par(std::string_view(big), ';'));
+    strutil::set_parallel_threads(0);
+}
+#endif // STRUTIL_ENABLE_PARALLEL
+
 TEST(Splitting, split_any)
 {
     std::vector<std::string> res;
@@ -576,6 +985,300 @@ TEST(Splitting, split_any)
     EXPECT_TRUE(res.empty());
 }
 
+TEST(SplittingView, split_char_delim)
+{
+    const std::string line = ";abc;;def;";
+    std::vector<std::string_view> res = strutil::split(std::string_view(line), ';');
+    std::vector<std::string_view> expected = { "", "abc", "", "def", "" };
+    EXPECT_EQ(res, expected);
+
+    // Tokens are views into the input, not copies.
+    EXPECT_EQ(line.data() + 1, res[1].data());
+
+    res = strutil::split(std::string_view(line), ';', false);
+    expected = { "abc", "def" };
+    EXPECT_EQ(res, expected);
+
+    res = strutil::split(std::string_view(), ';');
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0], "");
+    EXPECT_TRUE(strutil::split(std::string_view(), ';', false).empty());
+}
+
+TEST(SplittingView, split_string_delim)
+{
+    const std::string line = ">=abc>=>=def>=";
+    std::vector<std::string_view> res = strutil::split(std::string_view(line), std::string_view(">="));
+    std::vector<std::string_view> expected = { "", "abc", "", "def", "" };
+    EXPECT_EQ(res, expected);
+    EXPECT_EQ(line.data() + 2, res[1].data());
+
+    res = strutil::split(std::string_view(line), std::string_view(">="), false);
+    expected = { "abc", "def" };
+    EXPECT_EQ(res, expected);
+
+    // An empty delimiter never matches.
+    res = strutil::split(std::string_view("abc"), std::string_view(""));
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0], "abc");
+}
+
+TEST(SplittingView, split_any)
+{
+    const std::string line = ",abc,;def;";
+    std::vector<std::string_view> res = strutil::split_any(std::string_view(line), ",;");
+    std::vector<std::string_view> expected = { "", "abc", "", "def", "" };
+    EXPECT_EQ(res, expected);
+    EXPECT_EQ(line.data() + 1, res[1].data());
+
+    res = strutil::split_any(std::string_view(line), ",;", false);
+    expected = { "abc", "def" };
+    EXPECT_EQ(res, expected);
+
+    res = strutil::split_any(std::string_view("abc;def"), "");
+    ASSERT_EQ(res.size(), 1);
+    EXPECT_EQ(res[0], "abc;def");
+}
+
+TEST(SplittingView, matches_owning_overloads)
+{
+    const std::string inputs[] = { "", ";", ";;", "a", "a;b", ";a;;b;", "abc;;;def" };
+    for (const auto & in : inputs)
+    {
+        for (bool keep_empty : { true, false })
+        {
+            const auto owned = strutil::split(in, ';', keep_empty);
+            const auto views = strutil::split(std::string_view(in), ';', keep_empty);
+            EXPECT_EQ(owned, std::vector<std::string>(views.begin(), views.end())) << in;
+
+            const auto owned_any = strutil::split_any(in, ";", keep_empty);
+            const auto views_any = strutil::split_any(std::string_view(in), ";", keep_empty);
+            EXPECT_EQ(owned_any, std::vector<std::string>(views_any.begin(), views_any.end())) << in;
+        }
+    }
+}
+
+TEST(SplittingLazy, split_view_matches_split)
+{
+    const std::string inputs[] = { "", ";", ";;", "a", "a;b", ";a;;b;", "abc;;;def", "abc" };
+    for (const auto & in : inputs)
+    {
+        for (bool keep_empty : { true, false })
+        {
+            const auto chars = strutil::split_view(in, ';', keep_empty);
+            EXPECT_EQ(strutil::split(std::string_view(in), ';', keep_empty),
+                      std::vector<std::string_view>(chars.begin(), chars.end())) << in;
+
+            const std::string doubled = strutil::join(strutil::split(in, ';'), ">=");
+            const auto strs = strutil::split_view(doubled, std::string_view(">="), keep_empty);
+            EXPECT_EQ(strutil::split(std::string_view(doubled), std::string_view(">="), keep_empty),
+                      std::vector<std::string_view>(strs.begin(), strs.end())) << doubled;
+
+            const auto any = strutil::split_any_view(in, ",;", keep_empty);
+            EXPECT_EQ(strutil::split_any(std::string_view(in), ",;", keep_empty),
+                      std::vector<std::string_view>(any.begin(), any.end())) << in;
+        }
+    }
+}
+
+TEST(SplittingLazy, split_view_range_for_and_early_exit)
+{
+    const std::string line = "GET\t/index.html\t200\t512\tMozilla";
+
+    std::vector<std::string_view> fields;
+    for (std::string_view field : strutil::split_view(line, '\t'))
+    {
+        fields.push_back(field);
+        if (fields.size() == 3)
+        {
+            break;
+        }
+    }
+
+    const std::vector<std::string_view> expected = { "GET", "/index.html", "200" };
+    EXPECT_EQ(expected, fields);
+    EXPECT_EQ(line.data() + 4, fields[1].data());
+}
+
+TEST(SplittingLazy, parse_kv)
+{
+    using pairs = std::vector<std::pair<std::string_view, std::string_view>>;
+
+    const std::string query = "a=1&b=&c&&d=x=y&";
+    EXPECT_EQ(pairs({ { "a", "1" }, { "b", "" }, { "c", "" }, { "d", "x=y" } }), strutil::parse_kv(query, '&', '='));
+    EXPECT_EQ(query.data(), strutil::parse_kv(query, '&', '=').front().first.data());
+    EXPECT_TRUE(strutil::parse_kv("", '&', '=').empty());
+
+    EXPECT_EQ(pairs({ { "k", "v" }, { "k2", "v 2" } }), strutil::parse_kv(" k = v ;  ; k2=v 2 ", ';', '=', true));
+    EXPECT_EQ(pairs({ { " k ", " v " }, { "  ", "" } }), strutil::parse_kv(" k = v ;  ", ';', '='));
+}
+
+TEST(SplittingLazy, parse_kv_duplicates)
+{
+    using pairs = std::vector<std::pair<std::string_view, std::string_view>>;
+
+    const std::string_view fields = "x=1;y=2;x=3;z=4;y=5";
+    EXPECT_EQ(5u, strutil::parse_kv(fields, ';', '=').size());
+    EXPECT_EQ(pairs({ { "x", "1" }, { "y", "2" }, { "z", "4" } }),
+              strutil::parse_kv(fields, ';', '=', false, strutil::duplicate_keys::keep_first));
+    EXPECT_EQ(pairs({ { "x", "3" }, { "z", "4" }, { "y", "5" } }),
+              strutil::parse_kv(fields, ';', '=', false, strutil::duplicate_keys::keep_last));
+}
+
+TEST(SplittingLazy, kv_view)
+{
+    const std::string_view fields = " a = 1 ; ; b=2;c ";
+    std::vector<std::pair<std::string_view, std::string_view>> lazy;
+    for (const auto & pair : strutil::kv_view(fields, ';', '=', true))
+    {
+        lazy.push_back(pair);
+    }
+    EXPECT_EQ(strutil::parse_kv(fields, ';', '=', true), lazy);
+
+    const strutil::kv_view view("k=v", ';', '=');
+    auto it = view.begin();
+    EXPECT_EQ("k", it->first);
+    EXPECT_EQ("v", (*it++).second);
+    EXPECT_EQ(view.end(), it);
+
+    const strutil::kv_view blank(" ; ", ';', '=', true);
+    EXPECT_EQ(blank.end(), blank.begin());
+}
+
+TEST(SplittingLazy, split_view_iterator)
+{
+    const strutil::split_view view("a,,b", ',', false);
+    auto it = view.begin();
+    ASSERT_NE(it, view.end());
+    EXPECT_EQ("a", *it);
+    EXPECT_EQ(1u, it->size());
+
+    auto copy = it++;
+    EXPECT_EQ("a", *copy);
+    EXPECT_EQ("b", *it);
+    EXPECT_EQ(view.end(), ++it);
+
+    EXPECT_EQ(1, std::distance(strutil::split_view("abc", std::string_view("")).begin(),
+                               strutil::split_view("abc", std::string_view("")).end()));
+    const strutil::split_view empty("", ',', false);
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(SplittingSimd, char_kernels_match_scalar)
+{
+    // Random haystacks of every length up to a few blocks, with the needle at
+    // random offsets, so each kernel hits its vector loop and its tail path.
+    // Every start offset within a 64-byte block is tried, so unaligned heads
+    // are covered too.
+    std::string haystack;
+    unsigned seed = 12345;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+
+    for (size_t length = 0; length < 300; ++length)
+    {
+        haystack.assign(length + 63, 'x');
+        for (size_t i = 0; i < haystack.size(); ++i)
+        {
+            haystack[i] = static_cast<char>("ab\t,\x80\xff"[next() % 6]);
+        }
+
+        for (size_t offset = 0; offset < 64; ++offset)
+        {
+            for (char c : { '\t', ',', 'z', '\xff' })
+            {
+                const char * first = haystack.data() + offset;
+                const char * last  = first + length;
+                const char * expected_pos   = strutil::detail::find_char_scalar(first, last, c);
+                const size_t expected_count = strutil::detail::count_char_scalar(first, last, c);
+
+                EXPECT_EQ(expected_pos,   strutil::detail::find_char(first, last, c));
+                EXPECT_EQ(expected_count, strutil::detail::count_char(first, last, c));
+#if defined(STRUTIL_X86_SIMD)
+                EXPECT_EQ(expected_pos,   strutil::detail::find_char_sse2(first, last, c));
+                EXPECT_EQ(expected_count, strutil::detail::count_char_sse2(first, last, c));
+                if (strutil::detail::cpu().avx2)
+                {
+                    EXPECT_EQ(expected_pos,   strutil::detail::find_char_avx2(first, last, c));
+                    EXPECT_EQ(expected_count, strutil::detail::count_char_avx2(first, last, c));
+                }
+                if (strutil::detail::cpu().avx512bw)
+                {
+                    EXPECT_EQ(expected_pos,   strutil::detail::find_char_avx512(first, last, c));
+                    EXPECT_EQ(expected_count, strutil::detail::count_char_avx512(first, last, c));
+                }
+#endif
+            }
+        }
+    }
+
+    // Long run where every byte matches exercises the counter folding in count_char.
+    const std::string zeros(100000, '0');
+    EXPECT_EQ(100000u, strutil::detail::count_char(zeros.data(), zeros.data() + zeros.size(), '0'));
+}
+
+TEST(SplittingSimd, char_set_matches_scalar)
+{
+    constexpr strutil::char_set delims(",;\t\x80\xff");
+    static_assert(delims.contains(';') && !delims.contains('a'), "char_set is usable at compile time");
+    static_assert((~delims).contains('a') && !(~delims).contains('\x80'), "complement is usable at compile time");
+
+    std::string haystack;
+    unsigned seed = 4321;
+    auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+
+    for (size_t length = 0; length < 300; ++length)
+    {
+        haystack.assign(length, 'x');
+        for (size_t i = 0; i < length; ++i)
+        {
+            // Sparse hits, so the vector loops run before a match is found.
+            haystack[i] = static_cast<char>(next() % 16 == 0 ? ",;\t\x80\xff"[next() % 5] : "ab\x7f\x81\xfe\x08"[next() % 6]);
+        }
+
+        for (size_t pos = 0; pos <= length; pos += 7)
+        {
+            const size_t expected = std::string_view(haystack).find_first_of(std::string_view(",;\t\x80\xff", 5), pos);
+            EXPECT_EQ(expected, strutil::find_first_of(haystack, delims, pos));
+        }
+
+        std::vector<std::string_view> tokens;
+        for (size_t start = 0;;)
+        {
+            const size_t end = std::string_view(haystack).find_first_of(std::string_view(",;\t\x80\xff", 5), start);
+            tokens.push_back(std::string_view(haystack).substr(start, end - start));
+            if (end == std::string_view::npos) break;
+            start = end + 1;
+        }
+        EXPECT_EQ(tokens, strutil::split_any(haystack, delims));
+    }
+
+    // Every byte value, as a member and as a non-member.
+    for (unsigned byte = 0; byte < 256; ++byte)
+    {
+        const std::string text = std::string(40, static_cast<char>(byte ^ 1)) + static_cast<char>(byte);
+        EXPECT_EQ(40u, strutil::find_first_of(text, strutil::char_set().insert(static_cast<char>(byte))));
+        EXPECT_EQ(std::string_view::npos, strutil::find_first_of(text.substr(0, 40), strutil::char_set().insert(static_cast<char>(byte))));
+    }
+}
+
+TEST(SplittingSimd, split_long_line)
+{
+    std::string line;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 1000; ++i)
+    {
+        expected.push_back(std::string(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26)));
+        line += expected.back();
+        line += '\t';
+    }
+    expected.emplace_back();
+
+    EXPECT_EQ(expected, strutil::split(line, '\t'));
+
+    const auto lazy = strutil::split_view(line, '\t');
+    EXPECT_EQ(expected, std::vector<std::string>(lazy.begin(), lazy.end()));
+}
+
 TEST(Regexsplitting, regex_split)
 {
     std::vector<std::string> res;
@@ -630,6 +1333,74 @@ TEST(Regexsplitting, regex_split)
     EXPECT_EQ(res[2], "c");
 }
 
+TEST(Regexsplitting, regex_split_precompiled)
+{
+    const std::regex delims("[,;]+");
+    const std::vector<std::string> expected = { "a", "b", "c" };
+    EXPECT_EQ(expected, strutil::regex_split("a,b;;c", delims));
+    EXPECT_EQ(expected, strutil::regex_split(",a,b;;c", delims, false));
+
+    const auto map = strutil::regex_split_map("[x] 1 [y] 2", std::regex("\\[[a-z]\\]"));
+    ASSERT_EQ(2u, map.size());
+    EXPECT_EQ(" 1 ", map.at("[x]"));
+}
+
+TEST(Regexsplitting, regex_cache)
+{
+    strutil::regex_cache cache(2);
+    EXPECT_EQ(2u, cache.capacity());
+
+    const std::vector<std::string> expected = { "a", "b" };
+    EXPECT_EQ(expected, strutil::regex_split("a,b", "[,]", cache));
+    EXPECT_EQ(expected, strutil::regex_split("a,b", "[,]", cache));
+    EXPECT_EQ(1u, cache.misses());
+    EXPECT_EQ(1u, cache.hits());
+
+    // Flags are part of the key.
+    const auto ecma  = cache.get("[,]");
+    const auto posix = cache.get("[,]", std::regex::extended);
+    EXPECT_NE(ecma.get(), posix.get());
+    EXPECT_EQ(2u, cache.size());
+
+    // The least recently used entry ("[,]" with ECMAScript) is evicted and
+    // compiled again; handed-out pointers stay valid.
+    cache.get("x+");
+    EXPECT_EQ(2u, cache.size());
+    cache.get("[,]");
+    EXPECT_EQ(2u, cache.hits());
+    EXPECT_EQ(4u, cache.misses());
+    EXPECT_TRUE(std::regex_search("a,b", *ecma));
+
+    EXPECT_EQ(1u, strutil::regex_split_map("[k] v", "\\[k\\]", cache).size());
+
+    EXPECT_THROW(cache.get("(unclosed"), std::regex_error);
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(0u, cache.hits());
+}
+
+TEST(Regexsplitting, regex_split_dfa_regex)
+{
+    const strutil::dfa_regex delims("[,;]\\s*");
+    const std::vector<std::string> expected = { "a", "b", "", "c" };
+    EXPECT_EQ(expected, strutil::regex_split("a, b;;c", delims));
+    EXPECT_EQ(strutil::regex_split("a, b;;c,", std::regex("[,;]\\s*")), strutil::regex_split("a, b;;c,", delims));
+    EXPECT_EQ(std::vector<std::string>({ "a", "b", "c" }), strutil::regex_split(";a, b;;c", delims, false));
+    EXPECT_EQ(std::vector<std::string>({ "" }), strutil::regex_split("", delims));
+    EXPECT_EQ(std::vector<std::string>({ "abc" }), strutil::regex_split("abc", delims));
+
+    // Empty matches never delimit.
+    EXPECT_EQ(std::vector<std::string>({ "a", "b" }), strutil::regex_split("axxb", strutil::dfa_regex("x*")));
+    // After an empty match the same offset is retried for a non-empty one,
+    // as std::regex_iterator does, so lazy delimiters still split.
+    EXPECT_EQ(std::vector<std::string>({ "x", "", "y" }), strutil::regex_split("xaay", strutil::dfa_regex("a?\?")));
+    EXPECT_EQ(std::vector<std::string>({ "a", "", "b" }), strutil::regex_split("axxb", strutil::dfa_regex("x*?")));
+
+    const auto map = strutil::regex_split_map("[x] 1 [y] 2", strutil::dfa_regex("\\[[a-z]\\]"));
+    EXPECT_EQ(strutil::regex_split_map("[x] 1 [y] 2", std::regex("\\[[a-z]\\]")), map);
+}
+
 TEST(Regexsplitting_map, regex_split_map)
 {
     std::map<std::string, std::string> res = strutil::regex_split_map("[abc] name = 123; [abd] name = 123;[abe] name = 123;  ", "\\[[^\\]]+\\]");
@@ -647,6 +1418,37 @@ TEST(Regexsplitting_map, regex_split_map)
     }
 }
 
+TEST(Regexsplitting_map, regex_split_pairs)
+{
+    const std::string src = "[b] 1 [a] 2 [b] 3";
+    const std::regex  keys("\\[[a-z]\\]");
+    using pairs = std::vector<std::pair<std::string_view, std::string_view>>;
+
+    const pairs ordered = { { "[b]", " 1 " }, { "[a]", " 2 " }, { "[b]", " 3" } };
+    EXPECT_EQ(ordered, strutil::regex_split_pairs(src, keys));
+    EXPECT_EQ(ordered, strutil::regex_split_pairs(src, strutil::dfa_regex("\\[[a-z]\\]")));
+    EXPECT_TRUE(strutil::regex_split_pairs("no keys", keys).empty());
+
+    // Sorted by key; the later duplicate wins, as with std::map assignment.
+    const pairs sorted = { { "[a]", " 2 " }, { "[b]", " 3" } };
+    EXPECT_EQ(sorted, strutil::regex_split_map_view(src, keys));
+    EXPECT_EQ(sorted, strutil::regex_split_map_view(src, strutil::dfa_regex("\\[[a-z]\\]")));
+
+    // No copy of the input: the last value ends where src does.
+    const auto map = strutil::regex_split_map(src, keys);
+    ASSERT_EQ(2u, map.size());
+    EXPECT_EQ(" 3", map.at("[b]"));
+}
+
+TEST(Splitting, split_searcher)
+{
+    const strutil::searcher delim("::");
+    const std::vector<std::string_view> expected = { "a", "b", "", "c" };
+    EXPECT_EQ(expected, strutil::split(std::string_view("a::b::::c"), delim));
+    EXPECT_EQ(3u, strutil::split(std::string_view("a::b::::c"), delim, false).size());
+    EXPECT_EQ(1u, strutil::split(std::string_view("a::b"), strutil::searcher("")).size());
+}
+
 TEST(SplittingVector, join)
 {
     std::string str1 = "Col1;Col2;Col3";
@@ -691,6 +1493,190 @@ TEST(SplittingVector, join_edge_cases)
     EXPECT_EQ(",,", strutil::join(std::vector<std::string>{ "", "", "" }, ","));
 }
 
+TEST(SplittingVector, join_element_types)
+{
+    EXPECT_EQ("0.1;-2.5;1e+300", strutil::join(std::vector<double>{ 0.1, -2.5, 1e300 }, ";"));
+    EXPECT_EQ("1,0,1", strutil::join(std::vector<bool>{ true, false, true }, ","));
+    EXPECT_EQ("a-b-c", strutil::join(std::vector<char>{ 'a', 'b', 'c' }, "-"));
+    EXPECT_EQ("x, y", strutil::join(std::vector<const char *>{ "x", "y" }, ", "));
+    EXPECT_EQ("k=v", strutil::join(std::vector<std::string_view>{ "k", "v" }, std::string("=")));
+}
+
+TEST(SplittingVector, append_join)
+{
+    std::string row = "id,";
+    strutil::append_join(row, std::vector<std::string>{ "name", "size" }, ",");
+    row += '\n';
+    strutil::append_join(row, std::vector<long>{ 7, -12, 300 }, ",");
+    EXPECT_EQ("id,name,size\n7,-12,300", row);
+
+    strutil::append_join(row, std::vector<std::string>{}, ",");
+    EXPECT_EQ("id,name,size\n7,-12,300", row);
+}
+
+TEST(SplittingTable, append_split)
+{
+    strutil::string_table table;
+    strutil::append_split(table, "a,b,,c", ',');
+    EXPECT_EQ(4u, table.size());
+    EXPECT_EQ(3u, table.chars());
+    EXPECT_EQ(strutil::split(std::string_view("a,b,,c"), ','), std::vector<std::string_view>(table.begin(), table.end()));
+
+    // Appends, so batches of lines land in one table.
+    strutil::append_split(table, "d::e", "::");
+    strutil::append_split_any(table, "f;g h", strutil::char_set("; "), false);
+    strutil::append_split_any(table, " i", " ", false);
+    const std::vector<std::string_view> expected = { "a", "b", "", "c", "d", "e", "f", "g", "h", "i" };
+    EXPECT_EQ(expected, std::vector<std::string_view>(table.begin(), table.end()));
+    EXPECT_EQ("a", table.front());
+    EXPECT_EQ("i", table.back());
+    EXPECT_EQ("c", table[3]);
+    EXPECT_EQ(10, table.end() - table.begin());
+    EXPECT_EQ("e", *(table.begin() + 5));
+
+    table.clear();
+    EXPECT_TRUE(table.empty());
+    strutil::append_split(table, "", ',');
+    EXPECT_EQ(1u, table.size());
+}
+
+TEST(SplittingTable, append_many_records)
+{
+    // Record-by-record appends must grow the table geometrically; exact
+    // reserves made this loop quadratic.
+    strutil::string_table table;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const std::string record = std::to_string(i) + ",x," + std::to_string(i % 7);
+        strutil::append_split(table, record, ',');
+        strutil::append_split_any(table, "y", " ");
+    }
+    EXPECT_EQ(400000u, table.size());
+    EXPECT_EQ("99999", table[399996]);
+    EXPECT_EQ("x", table[399997]);
+    EXPECT_EQ("y", table.back());
+}
+
+TEST(SplittingTable, append_regex_split)
+{
+    const std::vector<std::string> inputs = { "a, b;;c,", ";a", "", "abc" };
+    for (const std::string & input : inputs)
+    {
+        for (bool keep_empty : { true, false })
+        {
+            strutil::string_table from_std;
+            strutil::append_regex_split(from_std, input, std::regex("[,;]\\s*"), keep_empty);
+            const auto expected = strutil::regex_split(input, std::regex("[,;]\\s*"), keep_empty);
+            EXPECT_EQ(expected, std::vector<std::string>(from_std.begin(), from_std.end()));
+
+            strutil::string_table from_dfa;
+            strutil::append_regex_split(from_dfa, input, strutil::dfa_regex("[,;]\\s*"), keep_empty);
+            EXPECT_EQ(from_std, from_dfa);
+        }
+    }
+}
+
+TEST(SplittingTable, join_drop_and_sort)
+{
+    const std::vector<std::string> words = { "pear", "", "apple", "pear", "fig", "" };
+    strutil::string_table table(words.begin(), words.end());
+    EXPECT_EQ("pear,,apple,pear,fig,", strutil::join(table, ","));
+
+    strutil::drop_empty(table);
+    EXPECT_EQ("pear,apple,pear,fig", strutil::join(table, ","));
+    EXPECT_EQ("pear apple pear fig", strutil::join(strutil::drop_empty_copy(strutil::string_table(words.begin(), words.end())), " "));
+
+    strutil::sorting_descending(table);
+    EXPECT_EQ("pear,pear,fig,apple", strutil::join(table, ","));
+    strutil::sorting_ascending(table);
+    EXPECT_EQ("apple,fig,pear,pear", strutil::join(table, ","));
+
+    strutil::drop_duplicate(table);
+    EXPECT_EQ("apple,fig,pear", strutil::join(table, ","));
+    EXPECT_EQ(",apple,fig,pear", strutil::join(strutil::drop_duplicate_copy(strutil::string_table(words.begin(), words.end())), ","));
+}
+
+TEST(SplittingInterned, intern_pool)
+{
+    strutil::intern_pool pool(3);
+    std::string host = "example.org";
+    const std::string_view first = pool.intern(host);
+    host[0] = 'X';
+    EXPECT_EQ("example.org", first);
+    EXPECT_EQ(first.data(), pool.intern(std::string("example.org")).data());
+
+    const auto id = pool.intern_id("example.org");
+    EXPECT_EQ(first.data(), pool[id].data());
+    EXPECT_EQ(id, pool.find("example.org"));
+    EXPECT_FALSE(pool.find("example.com").has_value());
+    EXPECT_EQ("", pool[pool.intern_id("")]);
+
+    const std::string large(100000, 'z');
+    EXPECT_EQ(large, pool.intern(large));
+    EXPECT_EQ(3u, pool.size());
+}
+
+TEST(SplittingInterned, many_distinct_strings)
+{
+    // One shard takes every string; exact reserves made this quadratic.
+    strutil::intern_pool pool(1);
+    for (int i = 0; i < 200000; ++i)
+    {
+        pool.intern_id("key" + std::to_string(i));
+    }
+    EXPECT_EQ(200000u, pool.size());
+    EXPECT_EQ("key123456", pool[*pool.find("key123456")]);
+}
+
+TEST(SplittingInterned, split_interned)
+{
+    strutil::intern_pool pool;
+    const auto tokens = strutil::split_interned(pool, "200,404,,200,500", ',');
+    const std::vector<std::string_view> expected = { "200", "404", "", "200", "500" };
+    EXPECT_EQ(expected, tokens);
+    EXPECT_EQ(tokens[0].data(), tokens[3].data());
+    EXPECT_EQ(4u, pool.size());
+
+    const auto skipped = strutil::split_interned(pool, "500::301::", "::", false);
+    EXPECT_EQ(tokens[4].data(), skipped[0].data());
+    EXPECT_EQ(2u, skipped.size());
+
+    const auto ids = strutil::split_interned_ids(pool, "404,301,404", ',');
+    EXPECT_EQ(ids[0], ids[2]);
+    EXPECT_EQ(tokens[1].data(), pool[ids[0]].data());
+    EXPECT_EQ("301", pool[ids[1]]);
+}
+
+TEST(SplittingInterned, concurrent_intern)
+{
+    strutil::intern_pool pool;
+    std::vector<std::vector<strutil::intern_pool::id_type>> ids(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t)
+    {
+        threads.emplace_back([&pool, &ids, t]()
+        {
+            for (int i = 0; i < 20000; ++i)
+            {
+                ids[t].push_back(pool.intern_id("host-" + std::to_string((i * 7 + static_cast<int>(t)) % 5000)));
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(5000u, pool.size());
+    for (size_t t = 0; t < ids.size(); ++t)
+    {
+        for (int i = 0; i < 20000; ++i)
+        {
+            ASSERT_EQ("host-" + std::to_string((i * 7 + static_cast<int>(t)) % 5000), pool[ids[t][i]]);
+        }
+    }
+}
+
 TEST(SplittingDropEmptyVector, drop_empty)
 {
     std::vector<std::string> tokens = { "t1", "t2", "", "t4", "" };
@@ -754,6 +1740,42 @@ TEST(TestDropDuplicateCopy, drop_duplicate_copy)
     EXPECT_EQ(std::equal(str2.cbegin(), str2.cend(), str3.cbegin()), true);
 }
 
+TEST(TestDropDuplicateStable, drop_duplicate_stable)
+{
+    std::vector<std::string> str1 = { "t1", "t2", "", "t4", "", "t1"};
+    strutil::drop_duplicate_stable(str1);
+
+    std::vector<std::string> str2 = { "t1", "t2", "", "t4"};
+    EXPECT_EQ(str2, str1);
+    EXPECT_EQ(str2, strutil::drop_duplicate_stable_copy(std::vector<std::string> { "t1", "t2", "t2", "", "t4", "", "t1" }));
+
+    std::vector<int> numbers = { 3, 1, 3, 2, 1, 0 };
+    strutil::drop_duplicate_stable(numbers);
+    EXPECT_EQ((std::vector<int> { 3, 1, 2, 0 }), numbers);
+
+    std::vector<std::string_view> none;
+    strutil::drop_duplicate_stable(none);
+    EXPECT_TRUE(none.empty());
+}
+
+TEST(TestDropDuplicateUnordered, drop_duplicate_unordered)
+{
+    std::vector<std::string> tokens;
+    for (int i = 0; i < 10000; ++i)
+    {
+        tokens.push_back("token" + std::to_string(i * 31 % 1237));
+    }
+
+    auto unordered = strutil::drop_duplicate_unordered_copy(tokens);
+    EXPECT_EQ(1237u, unordered.size());
+    std::sort(unordered.begin(), unordered.end());
+    EXPECT_EQ(strutil::drop_duplicate_copy(tokens), unordered);
+
+    strutil::drop_duplicate_unordered(tokens);
+    EXPECT_EQ(std::set<std::string>(unordered.begin(), unordered.end()), std::set<std::string>(tokens.begin(), tokens.end()));
+    EXPECT_EQ(1237u, tokens.size());
+}
+
 #ifdef STRUTIL_ENABLE_PARALLEL
 TEST(TestDropDuplicatePar, drop_duplicate_par)
 {
@@ -773,6 +1795,87 @@ TEST(TestDropDuplicateCopyPar, drop_duplicate_copy_par)
     std::vector<std::string> str2 = { "", "t1", "t2", "t4"};
     EXPECT_EQ(std::equal(str2.cbegin(), str2.cend(), str3.cbegin()), true);
 }
+
+TEST(ThreadPool, parallel_for)
+{
+    strutil::thread_pool pool(4);
+    EXPECT_EQ(4u, pool.concurrency());
+
+    std::vector<std::atomic<int>> hits(10007);
+    pool.parallel_for(hits.size(), 64, [&](size_t first, size_t last)
+    {
+        EXPECT_LE(last - first, 64u);
+        for (size_t i = first; i < last; ++i)
+        {
+            ++hits[i];
+        }
+    });
+    EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int> & hit) { return hit == 1; }));
+
+    // Nested calls finish: waiting threads run queued tasks themselves.
+    std::atomic<size_t> total { 0 };
+    pool.parallel_for(16, 1, [&](size_t, size_t)
+    {
+        pool.parallel_for(1000, 10, [&](size_t first, size_t last) { total += last - first; });
+    });
+    EXPECT_EQ(16000u, total);
+
+    // More callers than threads, with tasks long enough for waiters to go
+    // to sleep: every call still completes.
+    std::atomic<size_t> slow_total { 0 };
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 8; ++t)
+    {
+        callers.emplace_back([&]()
+        {
+            pool.parallel_for(8, 1, [&](size_t first, size_t last)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                pool.parallel_for(100, 10, [&](size_t a, size_t b) { slow_total += (last - first) * (b - a); });
+            });
+        });
+    }
+    for (std::thread & caller : callers)
+    {
+        caller.join();
+    }
+    EXPECT_EQ(6400u, slow_total);
+
+    // Work within the grain stays on the calling thread.
+    const auto caller = std::this_thread::get_id();
+    pool.parallel_for(64, 64, [&](size_t, size_t) { EXPECT_EQ(caller, std::this_thread::get_id()); });
+
+    EXPECT_THROW(pool.parallel_for(1000, 1, [](size_t first, size_t) { if (first == 500) throw std::runtime_error("task"); }), std::runtime_error);
+}
+
+TEST(ThreadPool, par_functions_match_serial)
+{
+    strutil::set_parallel_threads(3);
+    strutil::set_parallel_grain(500);
+    EXPECT_EQ(3u, strutil::parallel_threads());
+    EXPECT_EQ(500u, strutil::parallel_grain());
+
+    std::vector<std::string> strs;
+    for (int i = 0; i < 30000; ++i)
+    {
+        strs.push_back(std::to_string(i * 7919 % 10007));
+    }
+
+    auto ascending = strs;
+    strutil::sorting_ascending_par(ascending);
+    auto expected = strs;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, ascending);
+
+    auto descending = strs;
+    strutil::sorting_descending_par(descending);
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), descending.begin()));
+
+    EXPECT_EQ(strutil::drop_duplicate_copy(strs), strutil::drop_duplicate_copy_par(strs));
+
+    strutil::set_parallel_grain(2048);
+    strutil::set_parallel_threads(0);
+}
 #endif // STRUTIL_ENABLE_PARALLEL
 
 /*
@@ -791,6 +1894,25 @@ TEST(TextManip, to_upper)
     EXPECT_EQ("", strutil::to_upper(""));
 }
 
+TEST(TextManip, to_lower_upper_inplace)
+{
+    std::string str = "HeLlo StRUTIL 123 \xC3\x84";
+    strutil::to_lower_inplace(str);
+    EXPECT_EQ("hello strutil 123 \xC3\x84", str);
+
+    strutil::to_upper_inplace(str);
+    EXPECT_EQ("HELLO STRUTIL 123 \xC3\x84", str);
+
+    std::string empty;
+    strutil::to_lower_inplace(empty);
+    EXPECT_EQ("", empty);
+
+    // Long enough to go through the vector kernels; non-ASCII bytes are kept.
+    const std::string mixed = strutil::repeat("aZ@[`{\x80\xFF", 20);
+    EXPECT_EQ(strutil::repeat("az@[`{\x80\xFF", 20), strutil::to_lower(mixed));
+    EXPECT_EQ(strutil::repeat("AZ@[`{\x80\xFF", 20), strutil::to_upper(mixed));
+}
+
 TEST(TextManip, capitalize)
 {
     EXPECT_EQ("HeLlo StRUTIL", strutil::capitalize("heLlo StRUTIL"));
@@ -844,6 +1966,104 @@ TEST(TextManip, trim_both)
     EXPECT_EQ("HeLlo StRUTIL", strutil::trim_copy("    HeLlo StRUTIL      "));
 }
 
+TEST(TextManip, trim_view)
+{
+    const std::string_view padded = " \t HeLlo StRUTIL \n ";
+    EXPECT_EQ("HeLlo StRUTIL \n ", strutil::trim_left_view(padded));
+    EXPECT_EQ(" \t HeLlo StRUTIL", strutil::trim_right_view(padded));
+    EXPECT_EQ("HeLlo StRUTIL", strutil::trim_view(padded));
+    EXPECT_EQ(padded.data() + 3, strutil::trim_view(padded).data());
+    EXPECT_EQ("", strutil::trim_view("   "));
+    EXPECT_EQ("", strutil::trim_view(""));
+}
+
+TEST(TextManip, trim_char_set)
+{
+    const strutil::char_set junk("-_ ");
+    EXPECT_EQ("a-b", strutil::trim_view("-_ a-b _", junk));
+    EXPECT_EQ("a-b _", strutil::trim_left_view("-_ a-b _", junk));
+    EXPECT_EQ("-_ a-b", strutil::trim_right_view("-_ a-b _", junk));
+    EXPECT_EQ("", strutil::trim_view("--", junk));
+
+    std::string str = "xxhixx";
+    strutil::trim_left(str, strutil::char_set("x"));
+    EXPECT_EQ("hixx", str);
+    strutil::trim_right(str, strutil::char_set("x"));
+    EXPECT_EQ("hi", str);
+    EXPECT_EQ(".50", strutil::trim_left_view("000.50", strutil::char_set("0")));
+    EXPECT_EQ("a b", strutil::trim_copy(" \t\na b\r\n", strutil::char_set::space()));
+
+    str = "[[x]]";
+    strutil::trim(str, strutil::char_set("[]"));
+    EXPECT_EQ("x", str);
+}
+
+TEST(TextManip, batch_transforms)
+{
+    std::vector<std::string> strs = { "  Alpha ", "\tbeta\n", "", " GAMMA" };
+    strutil::trim_all(strs);
+    EXPECT_EQ((std::vector<std::string> { "Alpha", "beta", "", "GAMMA" }), strs);
+    strutil::to_lower_all(strs);
+    EXPECT_EQ((std::vector<std::string> { "alpha", "beta", "", "gamma" }), strs);
+    strutil::to_upper_all(strs);
+    EXPECT_EQ((std::vector<std::string> { "ALPHA", "BETA", "", "GAMMA" }), strs);
+    strutil::transform_all(strs, [](std::string & str) { strutil::replace_all(str, "A", "a"); });
+    EXPECT_EQ((std::vector<std::string> { "aLPHa", "BETa", "", "GaMMa" }), strs);
+
+    std::list<std::string> padded = { "--x--", "y-" };
+    strutil::trim_all(padded, strutil::char_set("-"));
+    EXPECT_EQ((std::list<std::string> { "x", "y" }), padded);
+
+    const std::vector<std::string_view> numbers = { "1", " 22", "x", "-4" };
+    EXPECT_EQ((std::vector<int> { 1, 22, 0, -4 }), strutil::parse_all<int>(numbers));
+    EXPECT_EQ((std::vector<double> { 0.5, 2.0 }), strutil::parse_all<double>(std::vector<std::string> { "0.5", "2" }));
+}
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+TEST(TextManip, batch_transforms_par)
+{
+    strutil::set_parallel_threads(4);
+    strutil::set_parallel_grain(100);
+    std::vector<std::string> strs;
+    for (int i = 0; i < 20000; ++i)
+    {
+        strs.push_back(" Item" + std::to_string(i) + "\t");
+    }
+    auto expected = strs;
+    strutil::trim_all(expected);
+    strutil::to_upper_all(expected);
+
+    strutil::trim_all_par(strs);
+    strutil::to_upper_all_par(strs);
+    EXPECT_EQ(expected, strs);
+    strutil::to_lower_all_par(strs);
+    strutil::to_lower_all(expected);
+    EXPECT_EQ(expected, strs);
+
+    strutil::transform_all_par(strs, [](std::string & str) { str.erase(0, 4); });
+    const auto values = strutil::parse_all_par<int>(strs);
+    ASSERT_EQ(strs.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(static_cast<int>(i), values[i]);
+    }
+    EXPECT_EQ(strutil::parse_all<int>(strs), values);
+
+    // Bits of std::vector<bool> share words, so blocks must not write it directly.
+    std::vector<std::string> flags;
+    for (int i = 0; i < 20000; ++i)
+    {
+        flags.push_back(i % 3 == 0 ? "1" : "0");
+    }
+    const auto bools = strutil::parse_all_par<bool>(flags);
+    EXPECT_EQ(strutil::parse_all<bool>(flags), bools);
+    EXPECT_TRUE(bools[0]);
+    EXPECT_FALSE(bools[19999]);
+    strutil::set_parallel_grain(2048);
+    strutil::set_parallel_threads(0);
+}
+#endif // STRUTIL_ENABLE_PARALLEL
+
 TEST(TextManip, trim_edge_cases)
 {
     // Empty string: should remain empty, no UB.
@@ -995,6 +2215,95 @@ TEST(TextManip, replace_all_target_empty)
     EXPECT_EQ("This is $name and that is also $name.", str1);
 }
 
+TEST(TextManip, replace_all_lengths_and_aliasing)
+{
+    std::string same = "a-b-c";
+    EXPECT_EQ(true, strutil::replace_all(same, "-", "+"));
+    EXPECT_EQ("a+b+c", same);
+
+    std::string shorter = "<br/>x<br/><br/>";
+    EXPECT_EQ(true, strutil::replace_all(shorter, "<br/>", "\n"));
+    EXPECT_EQ("\nx\n\n", shorter);
+
+    std::string overlapping = "aaaa";
+    EXPECT_EQ(true, strutil::replace_all(overlapping, "aa", "b"));
+    EXPECT_EQ("bb", overlapping);
+
+    // Target and replacement may point into the modified string itself.
+    std::string self = "abcab";
+    EXPECT_EQ(true, strutil::replace_all(self, std::string_view(self).substr(0, 2), std::string_view(self).substr(2, 1)));
+    EXPECT_EQ("ccc", self);
+}
+
+TEST(TextManip, replace_all_copy)
+{
+    const std::string_view input = "k1=v1;k2=v2";
+    EXPECT_EQ("k1: v1; k2: v2", strutil::replace_all_copy(strutil::replace_all_copy(input, "=", ": "), ";", "; "));
+    EXPECT_EQ("k1=v1;k2=v2", strutil::replace_all_copy(input, "", "x"));
+    EXPECT_EQ("k1=v1;k2=v2", strutil::replace_all_copy(input, "?", "x"));
+    EXPECT_EQ("", strutil::replace_all_copy("", "a", "b"));
+}
+
+TEST(TextManip, replace_with_searcher)
+{
+    const strutil::searcher name("$name");
+
+    std::string first = "$name and $name";
+    EXPECT_EQ(true, strutil::replace_first(first, name, "Jon"));
+    EXPECT_EQ("Jon and $name", first);
+
+    std::string last = "$name and $name";
+    EXPECT_EQ(true, strutil::replace_last(last, name, "Jon"));
+    EXPECT_EQ("$name and Jon", last);
+
+    std::string all = "$name and $name";
+    EXPECT_EQ(true, strutil::replace_all(all, name, "Jon Doe"));
+    EXPECT_EQ("Jon Doe and Jon Doe", all);
+    EXPECT_EQ(false, strutil::replace_all(all, name, "x"));
+
+    EXPECT_EQ("a--b", strutil::replace_all_copy("a, b", strutil::searcher(", "), "--"));
+    std::string unchanged = "abc";
+    EXPECT_EQ(false, strutil::replace_all(unchanged, strutil::searcher(""), "x"));
+}
+
+TEST(TextManip, replace_many)
+{
+    std::string html = "a < b && c > d";
+    EXPECT_EQ(true, strutil::replace_many(html, {{"&", "&amp;"}, {"<", "&lt;"}, {">", "&gt;"}}));
+    EXPECT_EQ("a &lt; b &amp;&amp; c &gt; d", html);
+
+    // Replaced text is not scanned again.
+    std::string swapped = "ab";
+    EXPECT_EQ(true, strutil::replace_many(swapped, {{"a", "b"}, {"b", "a"}}));
+    EXPECT_EQ("ba", swapped);
+
+    std::string untouched = "nothing to do";
+    EXPECT_EQ(false, strutil::replace_many(untouched, {{"x", "y"}, {"", "z"}}));
+    EXPECT_EQ("nothing to do", untouched);
+}
+
+TEST(TextManip, replace_many_leftmost_longest)
+{
+    const strutil::replacer replacements({{"he", "1"}, {"hers", "2"}, {"she", "3"}, {"s", "4"}});
+    EXPECT_EQ(4u, replacements.size());
+
+    // "she" starts before "hers"; at the same start the longest target wins.
+    EXPECT_EQ("3r4", strutil::replace_many_copy("shers", replacements));
+    EXPECT_EQ("2 1", strutil::replace_many_copy("hers he", replacements));
+    EXPECT_EQ("4x4", strutil::replace_many_copy("sxs", replacements));
+
+    // Same result as replace_all for a single target, including self-overlap.
+    const strutil::replacer single(std::map<std::string, std::string>{{"aa", "b"}});
+    EXPECT_EQ(strutil::replace_all_copy("aaaaa", "aa", "b"), strutil::replace_many_copy("aaaaa", single));
+
+    // A long target that keeps almost matching must not make the scan
+    // reread the input after every short match.
+    const strutil::replacer lookahead({{"a", "x"}, {std::string(4096, 'a') + "b", "y"}});
+    EXPECT_EQ(std::string(1 << 20, 'x'), strutil::replace_many_copy(std::string(1 << 20, 'a'), lookahead));
+    EXPECT_EQ("y" + std::string(10, 'x'), strutil::replace_many_copy(std::string(4096, 'a') + "b" + std::string(10, 'a'), lookahead));
+    EXPECT_EQ("xy", strutil::replace_many_copy(std::string(4097, 'a') + "b", lookahead));
+}
+
 TEST(TextSortAscending, sorting_ascending)
 {
     std::vector<std::string> str1 = {"ABC", "abc", "bcd", "", "-", "  ", "123", "-100"};
@@ -1013,6 +2322,122 @@ TEST(TextSortDescending, sorting_descending)
     EXPECT_EQ(std::equal(str1.cbegin(), str1.cend(), str2.cbegin()), true);
 }
 
+TEST(TextSortAscending, string_sort_matches_std_sort)
+{
+    // Enough elements for the multikey quicksort: shared prefixes longer
+    // than a key, embedded NULs, strings ending inside a key and duplicates.
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::string str = (i % 3 == 0) ? "https://example.org/path/" : "";
+        str += std::to_string(i * 7919 % 1009);
+        if (i % 5 == 0)
+        {
+            str += std::string(static_cast<size_t>(i % 4), '\0');
+        }
+        strs.push_back(str);
+    }
+    auto expected = strs;
+    std::sort(expected.begin(), expected.end());
+
+    auto ascending = strs;
+    strutil::sorting_ascending(ascending);
+    EXPECT_EQ(expected, ascending);
+
+    std::vector<std::string_view> views(strs.begin(), strs.end());
+    strutil::sorting_descending(views);
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), views.begin(), views.end()));
+
+    // Other element types keep using std::sort.
+    std::vector<int> numbers = { 3, -1, 2 };
+    strutil::sorting_descending(numbers);
+    EXPECT_EQ((std::vector<int> { 3, 2, -1 }), numbers);
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+    strutil::set_parallel_threads(4);
+    strutil::set_parallel_grain(100);
+    auto ascending_par = strs;
+    strutil::sorting_ascending_par(ascending_par);
+    EXPECT_EQ(expected, ascending_par);
+    auto descending_par = strs;
+    strutil::sorting_descending_par(descending_par);
+    EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), descending_par.begin()));
+    strutil::set_parallel_grain(2048);
+    strutil::set_parallel_threads(0);
+#endif // STRUTIL_ENABLE_PARALLEL
+}
+
+TEST(TextSortAscending, sorting_ascending_ci)
+{
+    std::vector<std::string> str1 = {"banana", "Apple", "cherry", "apple", "Banana", "APPLE"};
+    strutil::sorting_ascending_ci(str1);
+    EXPECT_EQ((std::vector<std::string> {"Apple", "apple", "APPLE", "banana", "Banana", "cherry"}), str1);
+
+    // Matches a stable sort with a lowering comparator, past the key sort threshold.
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; ++i)
+    {
+        std::string str = (i % 2 == 0) ? "Path/" : "path/";
+        str += std::to_string(i * 7919 % 1009);
+        strs.push_back(i % 3 == 0 ? strutil::to_upper(str) : str);
+    }
+    auto expected = strs;
+    std::stable_sort(expected.begin(), expected.end(), [](const std::string & a, const std::string & b)
+    {
+        return strutil::to_lower(a) < strutil::to_lower(b);
+    });
+    auto sorted = strs;
+    strutil::sorting_ascending_ci(sorted);
+    EXPECT_EQ(expected, sorted);
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+    strutil::set_parallel_threads(4);
+    strutil::set_parallel_grain(100);
+    auto sorted_par = strs;
+    strutil::sorting_ascending_ci_par(sorted_par);
+    EXPECT_EQ(expected, sorted_par);
+    strutil::set_parallel_grain(2048);
+    strutil::set_parallel_threads(0);
+#endif // STRUTIL_ENABLE_PARALLEL
+}
+
+TEST(TextSortAscending, sorting_natural)
+{
+    std::vector<std::string> str1 = {"file10.txt", "file2.txt", "File1.txt", "file02.txt", "file", "file1000000000000000000000.txt", "10", "9"};
+    strutil::sorting_natural(str1);
+    EXPECT_EQ((std::vector<std::string> {"9", "10", "File1.txt", "file", "file2.txt", "file02.txt", "file10.txt",
+                                         "file1000000000000000000000.txt"}), str1);
+
+    std::vector<std::string_view> str2 = {"b3", "A10", "a2", "B1"};
+    strutil::sorting_natural(str2, true);
+    EXPECT_EQ((std::vector<std::string_view> {"a2", "A10", "B1", "b3"}), str2);
+
+    // Matches sorting by (prefix, number) past the key sort threshold.
+    std::vector<std::string> strs;
+    for (int i = 0; i < 3000; ++i)
+    {
+        strs.push_back(std::string(i % 2 == 0 ? "img" : "doc") + std::to_string(i * 7919 % 1009));
+    }
+    auto expected = strs;
+    std::stable_sort(expected.begin(), expected.end(), [](const std::string & a, const std::string & b)
+    {
+        return std::make_pair(a.substr(0, 3), std::stoi(a.substr(3))) < std::make_pair(b.substr(0, 3), std::stoi(b.substr(3)));
+    });
+    auto sorted = strs;
+    strutil::sorting_natural(sorted);
+    EXPECT_EQ(expected, sorted);
+
+#ifdef STRUTIL_ENABLE_PARALLEL
+    strutil::set_parallel_threads(4);
+    strutil::set_parallel_grain(100);
+    auto sorted_par = strs;
+    strutil::sorting_natural_par(sorted_par);
+    EXPECT_EQ(expected, sorted_par);
+    strutil::set_parallel_grain(2048);
+    strutil::set_parallel_threads(0);
+#endif // STRUTIL_ENABLE_PARALLEL
+}
+
 #ifdef STRUTIL_ENABLE_PARALLEL
 TEST(TextSortAscendingPar, sorting_ascending_par)
 {